@@ -0,0 +1,186 @@
+#include "cpu_model_020.h"
+#include "cpu_model_060.h"
+#include "parser.h"
+#include "instruction.h"
+#include <iostream>
+#include <sstream>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <string>
+
+// Throughput benchmark of the tool itself
+// Usage: acycles_bench [seed] [instructions]
+// Output is one "name<TAB>value<TAB>unit" line per measurement
+
+namespace {
+
+class generator {
+public:
+    explicit generator(uint32_t seed)
+        : rng_ { seed }
+    {
+    }
+
+    // A random (but not necessarily supported) instruction
+    std::string candidate()
+    {
+        const auto op = static_cast<opcode>(pick(num_opcodes));
+        std::ostringstream oss;
+        oss << "\t" << op;
+        if (is_branch(op)) {
+            oss << (pick(2) ? ".b" : ".w") << "\tlabel";
+            return oss.str();
+        }
+        oss << "." << "bwl"[pick(3)] << "\t";
+        if (op == opcode::dbra) {
+            oss << dreg() << ",label";
+            return oss.str();
+        }
+        const int nea = num_ea(op);
+        if (nea == 2) {
+            if (is_shift_rot(op) || op == opcode::addq || op == opcode::subq)
+                oss << "#" << 1 + pick(8) << ",";
+            else if (op == opcode::moveq)
+                oss << "#" << pick(256) - 128 << ",";
+            else
+                oss << any_ea() << ",";
+        }
+        if (nea)
+            oss << (op == opcode::moveq || is_shift_rot(op) ? dreg() : any_ea(false));
+        return oss.str();
+    }
+
+private:
+    std::mt19937 rng_;
+
+    int pick(int n)
+    {
+        return std::uniform_int_distribution<int> { 0, n - 1 }(rng_);
+    }
+
+    std::string dreg()
+    {
+        return "d" + std::to_string(pick(8));
+    }
+
+    std::string areg()
+    {
+        return "a" + std::to_string(pick(8));
+    }
+
+    std::string any_ea(bool allow_imm = true)
+    {
+        switch (pick(allow_imm ? 9 : 8)) {
+        case 0:
+        case 1:
+            return dreg();
+        case 2:
+            return areg();
+        case 3:
+            return "(" + areg() + ")";
+        case 4:
+            return "(" + areg() + ")+";
+        case 5:
+            return "-(" + areg() + ")";
+        case 6:
+            return std::to_string(pick(1024) - 512) + "(" + areg() + ")";
+        case 7:
+            return std::to_string(pick(256) - 128) + "(" + areg() + "," + (pick(2) ? dreg() : areg()) + (pick(2) ? ".l" : ".w") + "*" + "1248"[pick(4)] + ")";
+        default:
+            return "#$" + std::to_string(pick(100000));
+        }
+    }
+};
+
+bool supported(const instruction& i)
+{
+    // Check that both models can handle the instruction
+    std::ostream null_os { nullptr };
+    const std::vector<instruction> insts { i };
+    try {
+        make_cpu_model_020(null_os, insts)->simulate(0, false);
+        make_cpu_model_060(null_os, insts)->simulate(0, false);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+// Builds a source text of n instructions, all supported by both models
+std::string generate(uint32_t seed, size_t n)
+{
+    generator gen { seed };
+    std::vector<std::string> pool;
+    for (int tries = 0; pool.size() < 1000 && tries < 100000; ++tries) {
+        auto line = gen.candidate();
+        try {
+            if (auto i = parser { line }.next(); i && supported(*i))
+                pool.push_back(line);
+        } catch (const std::exception&) {
+        }
+    }
+    if (pool.empty())
+        throw std::runtime_error { "Could not generate any instructions" };
+
+    std::mt19937 rng { seed };
+    std::string text;
+    for (size_t i = 0; i < n; ++i) {
+        text += pool[std::uniform_int_distribution<size_t> { 0, pool.size() - 1 }(rng)];
+        text += '\n';
+    }
+    return text;
+}
+
+// Best time (in seconds) of a few runs
+double measure(const std::function<void()>& f)
+{
+    double best = 0;
+    for (int run = 0; run < 3; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!run || t < best)
+            best = t;
+    }
+    return best;
+}
+
+void report(const std::string& name, double value, const char* unit)
+{
+    std::cout << name << "\t" << static_cast<uint64_t>(value) << "\t" << unit << "\n";
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        const uint32_t seed = argc > 1 ? std::stoul(argv[1]) : 1;
+        const size_t n = argc > 2 ? std::stoul(argv[2]) : 100000;
+
+        const auto text = generate(seed, n);
+        std::cout << "seed\t" << seed << "\t-\n";
+        std::cout << "instructions\t" << n << "\t-\n";
+
+        std::vector<instruction> insts;
+        report("parse", n / measure([&]() { insts = parser { text }.all(); }), "lines/s");
+        instruction_arena packed;
+        report("parse_packed", n / measure([&]() { packed = parser { text }.all_packed(); }), "lines/s");
+        report("parse_parallel", n / measure([&]() { packed = parse_parallel(text, 0, 64 << 10); }), "lines/s");
+
+        std::ostream null_os { nullptr };
+        auto cpu_020 = make_cpu_model_020(null_os, insts);
+        report("cost_020", n / measure([&]() { cpu_020->simulate(0, false); }), "instructions/s");
+
+        auto cpu_060 = make_cpu_model_060(null_os, insts);
+        for (const int unroll : { 0, 10, 100 })
+            report("simulate_060_unroll_" + std::to_string(unroll), n * (unroll + 1) / measure([&]() { cpu_060->simulate(unroll, false); }), "instructions/s");
+        auto cpu_060_packed = make_cpu_model_060(null_os, packed);
+        report("simulate_060_packed_unroll_10", n * 11 / measure([&]() { cpu_060_packed->simulate(10, false); }), "instructions/s");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
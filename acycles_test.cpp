@@ -1,34 +1,206 @@
 #include "cpu_model_020.h"
 #include "cpu_model_060.h"
+#include "timeline.h"
 #include "parser.h"
-#include "util.h"
+#include "mapped_file.h"
+#include "batch.h"
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
 
-int main()
+// Checks the files in the tests directory (default ../tests) against the expected
+// results given as directives in their comments:
+//
+//   @020 b/c/w      68020 best/cache/worst cycles of the instruction on the line
+//   @060 pOEP|sOEP  68060 pipe of the instruction on the line (first iteration)
+//   @020.loop b/c/w 68020 cycles of one iteration (may be on any line)
+//   @060.loop n     68060 steady state cycles/iteration (may be on any line)
+//   @060.dcache n   Same with the 8 KB data cache modelled
+
+namespace {
+
+std::string to_string(const instruction& i)
+{
+    std::ostringstream oss;
+    oss << i;
+    return oss.str();
+}
+
+template<typename T>
+std::string to_string(const T& t)
+{
+    std::ostringstream oss;
+    oss << t;
+    return oss.str();
+}
+
+void check_same(const std::vector<instruction>& expected, const std::vector<instruction>& actual)
+{
+    if (expected.size() != actual.size())
+        throw std::runtime_error { "Mapped parse gave " + std::to_string(actual.size()) + " instructions, expected " + std::to_string(expected.size()) };
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (to_string(expected[i]) != to_string(actual[i]))
+            throw std::runtime_error { "Mapped parse mismatch: " + to_string(actual[i]) + " expected " + to_string(expected[i]) };
+    }
+}
+
+// Streaming the instructions must give the same result as one pass of the loop model
+void check_stream(const timeline_060& expected, const std::vector<instruction>& insts)
+{
+    timeline_060 actual { std::vector<issue_060>(insts.size()), 0, 0 };
+    timeline_sink_060 sink { actual };
+    stream_model_060 model { sink };
+    for (const auto& i : insts)
+        model.push(i);
+    if (model.finish() != expected.cycles || actual.cycles != expected.cycles)
+        throw std::runtime_error { "Stream took " + std::to_string(actual.cycles) + " cycles, expected " + std::to_string(expected.cycles) };
+    for (size_t i = 0; i < insts.size(); ++i) {
+        const auto& a = actual.instructions[i];
+        const auto& e = expected.instructions[i];
+        if (a.cycle != e.cycle || a.cycles != e.cycles || a.pipe != e.pipe || a.stall != e.stall || a.soep_idle.reason != e.soep_idle.reason)
+            throw std::runtime_error { "Stream mismatch for " + to_string(insts[i]) };
+    }
+}
+
+struct directive {
+    size_t line;
+    std::string key;
+    std::string value;
+};
+
+std::vector<directive> read_directives(std::string_view text)
+{
+    std::vector<directive> res;
+    for (size_t line = 1; !text.empty(); ++line) {
+        const auto eol = text.find('\n');
+        auto l = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+        const auto comment = l.find(';');
+        if (comment == std::string_view::npos)
+            continue;
+        std::istringstream iss { std::string { l.substr(comment + 1) } };
+        std::string word;
+        while (iss >> word) {
+            if (word[0] != '@')
+                continue;
+            directive d { line, word.substr(1), "" };
+            if (!(iss >> d.value))
+                throw std::runtime_error { "Line " + std::to_string(line) + ": Missing value for " + word };
+            res.push_back(d);
+        }
+    }
+    return res;
+}
+
+// Returns a description of each mismatch
+std::vector<std::string> check_file(const std::filesystem::path& path, std::ostream& summary)
+{
+    const auto filename = path.string();
+    std::ifstream in { path };
+    if (!in)
+        throw std::runtime_error { "Error opening file" };
+
+    std::vector<size_t> lines;
+    std::vector<instruction> insts;
+    parser p { in };
+    while (auto i = p.next()) {
+        insts.push_back(*i);
+        lines.push_back(p.line_number());
+    }
+    const mapped_file source { filename };
+    check_same(insts, parser { source.data() }.all());
+    check_same(insts, parser { source.data() }.all_packed().unpack());
+    check_same(insts, parse_parallel(source.data(), 2, 64).unpack());
+
+    // Line numbers of errors in later chunks must count from the start of the file
+    const auto bad_text = std::string { source.data() } + "\n\tbad_mnemonic\n";
+    const auto bad_line = static_cast<size_t>(std::count(bad_text.begin(), bad_text.end(), '\n'));
+    try {
+        parse_parallel(bad_text, 2, 64);
+        throw std::runtime_error { "No error from parse_parallel" };
+    } catch (const parse_error& e) {
+        if (e.line() != bad_line)
+            throw std::runtime_error { "parse_parallel reported line " + std::to_string(e.line()) + ", expected " + std::to_string(bad_line) };
+    }
+
+    timeline_builder builder;
+    timeline_020 res_020;
+    timeline_060 res_060;
+    builder.simulate_020(insts, res_020);
+    builder.simulate_060(insts, 0, res_060);
+    check_stream(res_060, insts);
+    std::ostream null_os { nullptr };
+    const auto ss_060 = make_cpu_model_060(null_os, insts)->find_steady_state();
+    summary << path.filename() << "\t" << res_020.total.cache << "\t" << ss_060.cycles_per_iteration() << "\n";
+
+    std::vector<std::string> errors;
+    auto check = [&](const directive& d, const std::string& actual) {
+        if (d.value != actual)
+            errors.push_back(filename + ":" + std::to_string(d.line) + ": @" + d.key + " expected " + d.value + " got " + actual);
+    };
+    for (const auto& d : read_directives(source.data())) {
+        if (d.key == "020.loop") {
+            check(d, to_string(res_020.total));
+        } else if (d.key == "060.loop") {
+            check(d, to_string(ss_060.cycles_per_iteration()));
+        } else if (d.key == "060.dcache") {
+            options_060 opts;
+            opts.data_cache_bytes = 8192;
+            check(d, to_string(make_cpu_model_060(null_os, insts, opts)->find_steady_state().cycles_per_iteration()));
+        } else if (d.key == "branch") {
+            // Input to the models
+        } else if (d.key == "020" || d.key == "060") {
+            const auto it = std::find(lines.begin(), lines.end(), d.line);
+            if (it == lines.end()) {
+                errors.push_back(filename + ":" + std::to_string(d.line) + ": @" + d.key + " on line without instruction");
+                continue;
+            }
+            const size_t pos = it - lines.begin();
+            if (d.key == "020") {
+                check(d, to_string(res_020.instructions[pos].cost));
+            } else {
+                const auto& r = res_060.instructions[pos];
+                check(d, r.branch ? "-" : to_string(r.pipe));
+            }
+        } else {
+            errors.push_back(filename + ":" + std::to_string(d.line) + ": Unknown directive @" + d.key);
+        }
+    }
+    return errors;
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
 {
-    std::string last_file;
-    try {        
-        for (const auto& fn : std::filesystem::recursive_directory_iterator(std::filesystem::path { ".." }  /  "tests")) {
-            last_file = fn.path().string();
-            std::ifstream in { fn.path() };
-            if (!in)
-                throw std::runtime_error { "Error opening file" };
-
-            // TODO: Check that cycle counts are correct (and stay correct)
-            const auto insts = parser { in }.all();
-            auto cpu_020 = make_cpu_model_020(std::cout, insts);
-            auto cpu_060 = make_cpu_model_060(std::cout, insts);
-            [[maybe_unused]] const auto res_020 = cpu_020->simulate(0, false);
-            [[maybe_unused]] const auto res_060 = cpu_060->simulate(0, false);
-            std::cout << fn.path().filename() << "\t" << res_020 << "\t" << res_060 << "\n";
+    const std::filesystem::path dir = argc > 1 ? std::filesystem::path { argv[1] } : std::filesystem::path { ".." } / "tests";
+    std::vector<std::filesystem::path> files;
+    for (const auto& fn : std::filesystem::recursive_directory_iterator(dir))
+        files.push_back(fn.path());
+    std::sort(files.begin(), files.end());
+
+    std::vector<std::string> summaries(files.size());
+    std::vector<std::vector<std::string>> errors(files.size());
+    parallel_for(files.size(), [&](size_t i) {
+        std::ostringstream summary;
+        try {
+            errors[i] = check_file(files[i], summary);
+        } catch (const std::exception& e) {
+            errors[i].push_back("Error while processing " + files[i].string() + "\n" + e.what());
         }
+        summaries[i] = summary.str();
+    });
 
-    } catch (const std::exception& e) {
-        if (!last_file.empty())
-            std::cerr << "Error while processing " << last_file << "\n";
-        std::cerr << e.what() << "\n";
+    int failed = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::cout << summaries[i];
+        for (const auto& e : errors[i])
+            std::cerr << e << "\n";
+        failed += !errors[i].empty();
+    }
+    if (failed) {
+        std::cerr << failed << " of " << files.size() << " files failed\n";
         return 1;
     }
     return 0;
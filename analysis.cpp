@@ -0,0 +1,341 @@
+#include "analysis.h"
+#include "cpu_model_020.h"
+#include "cpu_model_060.h"
+#include "timeline.h"
+#include "json.h"
+#include "profile.h"
+#include <ostream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+
+const char* const csv_report_header = "version,model,record,index,iteration,instruction,words,cycle,cycles,pipe,stall,stall_register,best,cache,worst,note";
+
+namespace {
+
+template<typename T>
+std::string to_string(const T& t)
+{
+    std::ostringstream oss;
+    oss << t;
+    return oss.str();
+}
+
+std::string instruction_text(const instruction& i)
+{
+    auto s = to_string(i);
+    for (auto& ch : s) {
+        if (ch == '\t')
+            ch = ' ';
+    }
+    return s;
+}
+
+// Bytes the 68060 fetches per iteration (correctly predicted branches aren't fetched)
+int fetched_bytes(instruction_view insts)
+{
+    int bytes = 0;
+    for (size_t i = 0; i < insts.size(); ++i) {
+        if (!is_branch(insts[i].op()))
+            bytes += insts[i].num_words() * 2;
+    }
+    return bytes;
+}
+
+// Cycles per iteration lost to instruction fetch (0 unless the loop is fetch-bound)
+double fetch_cost(instruction_view insts, const options_060& opts, const steady_state& ss)
+{
+    if (!opts.fetch_bytes_per_cycle)
+        return 0;
+    auto unlimited = opts;
+    unlimited.fetch_bytes_per_cycle = 0;
+    std::ostream null_os { nullptr };
+    return ss.cycles_per_iteration() - make_cpu_model_060(null_os, insts, unlimited)->find_steady_state().cycles_per_iteration();
+}
+
+json cycles_json(const cycle_counts& cc)
+{
+    json j;
+    j["best"] = cc.best;
+    j["cache"] = cc.cache;
+    j["worst"] = cc.worst;
+    return j;
+}
+
+// The report data for both machine-readable formats
+struct report {
+    instruction_view insts;
+    int model;
+    int instruction_words;
+    timeline_020 t020;
+    timeline_060 t060;
+    steady_state ss;
+    int fetch_bytes;
+    double fetch_cycles; // Per iteration lost to instruction fetch
+
+    explicit report(instruction_view instructions, const analysis_options& opts)
+        : insts { instructions }
+        , model { opts.model }
+        , instruction_words { 0 }
+        , t020 {}
+        , t060 {}
+        , ss {}
+        , fetch_bytes { 0 }
+        , fetch_cycles { 0 }
+    {
+        for (size_t i = 0; i < insts.size(); ++i)
+            instruction_words += insts[i].num_words();
+        timeline_builder builder { opts.cpu_060 };
+        if (model == 68060) {
+            builder.simulate_060(insts, opts.unroll, t060);
+            std::ostream null_os { nullptr };
+            ss = make_cpu_model_060(null_os, insts, opts.cpu_060)->find_steady_state();
+            fetch_bytes = fetched_bytes(insts);
+            fetch_cycles = fetch_cost(insts, opts.cpu_060, ss);
+        } else {
+            assert(model == 68020);
+            builder.simulate_020(insts, t020);
+        }
+    }
+
+    std::string soep_idle(size_t pos) const
+    {
+        const auto& check = t060.instructions[pos].soep_idle;
+        if (check.reason == soep_reason::none)
+            return {};
+        std::ostringstream oss;
+        print_reason(oss, check, insts[pos % insts.size()], insts[(pos + 1) % insts.size()]);
+        return oss.str();
+    }
+};
+
+void analyse_text(instruction_view insts, const analysis_options& opts, std::ostream& os)
+{
+    int instruction_words = 0;
+    for (size_t i = 0; i < insts.size(); ++i) {
+        instruction_words += insts[i].num_words();
+        //os << "\t" << with_width(i,30) << "; length " << i.num_words() << " \n";
+    }
+
+    if (opts.model == 68060) {
+        auto cpu = make_cpu_model_060(os, insts, opts.cpu_060);
+        cpu->simulate(opts.unroll, true);
+        const auto ss = cpu->find_steady_state();
+        os << "Instruction words in loop: " << instruction_words << ", " << ss.cycles_per_iteration() << " cycles/iteration";
+        if (!ss.exact)
+            os << " (approximate, no steady state found)";
+        os << "\n";
+        if (ss.prologue_cycles != ss.prologue_iterations * ss.cycles_per_iteration())
+            os << "Warm-up: " << ss.prologue_iterations << " iteration(s) taking " << ss.prologue_cycles << " cycles\n";
+        if (const double cost = fetch_cost(insts, opts.cpu_060, ss); cost > 0)
+            os << "Fetch-bound: " << fetched_bytes(insts) << " bytes/iteration at " << opts.cpu_060.fetch_bytes_per_cycle << " bytes/cycle, instruction fetch costs " << cost << " cycles/iteration\n";
+        if (opts.profile)
+            print_profile(make_profile_060(insts, opts.cpu_060), insts, os);
+    } else {
+        assert(opts.model == 68020);
+        auto cpu = make_cpu_model_020(os, insts);
+        cpu->simulate(0, true);
+        if (const auto ss = cpu->find_steady_state(); ss.period_iterations > 1)
+            os << "Average over " << ss.period_iterations << " iterations of the @branch patterns: " << ss.cycles_per_iteration() << " cycles/iteration (cache case)\n";
+    }
+}
+
+void analyse_json(const report& r, std::ostream& os)
+{
+    json j;
+    j["format"] = "acycles";
+    j["version"] = report_schema_version;
+    j["model"] = r.model;
+    j["instruction_words"] = r.instruction_words;
+    auto instructions = json::array();
+    for (size_t i = 0; i < r.insts.size(); ++i) {
+        json ij;
+        ij["index"] = i;
+        ij["instruction"] = instruction_text(r.insts[i]);
+        ij["words"] = r.insts[i].num_words();
+        if (r.model == 68020) {
+            ij["cost"] = cycles_json(r.t020.instructions[i].cost);
+            ij["assumed_taken"] = r.t020.instructions[i].assumed_taken;
+        }
+        instructions.push_back(std::move(ij));
+    }
+    j["instructions"] = std::move(instructions);
+
+    json totals;
+    if (r.model == 68060) {
+        auto issues = json::array();
+        for (size_t pos = 0; pos < r.t060.instructions.size(); ++pos) {
+            const auto& e = r.t060.instructions[pos];
+            json ij;
+            ij["position"] = pos;
+            ij["index"] = pos % r.insts.size();
+            ij["iteration"] = pos / r.insts.size();
+            ij["branch"] = e.branch;
+            ij["taken"] = e.branch ? json { e.taken } : json {};
+            ij["mispredicted"] = e.branch ? json { e.mispredicted } : json {};
+            ij["cycle"] = e.cycle;
+            ij["cycles"] = e.cycles;
+            ij["pipe"] = e.branch ? json {} : json { to_string(e.pipe) };
+            ij["stall"] = e.stall;
+            ij["stall_register"] = e.stall ? json { to_string(e.stall_reg) } : json {};
+            ij["fetch_stall"] = e.fetch_stall;
+            ij["data_cache_stall"] = e.data_cache_stall;
+            const auto idle = r.soep_idle(pos);
+            ij["soep_idle"] = idle.empty() ? json {} : json { idle };
+            issues.push_back(std::move(ij));
+        }
+        j["issues"] = std::move(issues);
+        totals["iterations"] = r.t060.unroll + 1;
+        totals["cycles"] = r.t060.cycles;
+        totals["cycles_per_iteration"] = r.ss.cycles_per_iteration();
+        totals["exact"] = r.ss.exact;
+        totals["warmup_iterations"] = r.ss.prologue_iterations;
+        totals["warmup_cycles"] = r.ss.prologue_cycles;
+        totals["fetch_bytes_per_iteration"] = r.fetch_bytes;
+        totals["fetch_stall_cycles_per_iteration"] = r.fetch_cycles;
+    } else {
+        totals["cycles"] = cycles_json(r.t020.total);
+    }
+    j["totals"] = std::move(totals);
+    os << j << "\n";
+}
+
+void analyse_csv(const report& r, std::ostream& os)
+{
+    os << csv_report_header << "\n";
+    auto row = [&](const char* record, const std::string& index, const std::string& iteration, const std::string& instruction, int words, const std::string& timing, const cycle_counts* cc, const std::string& note) {
+        os << report_schema_version << "," << r.model << "," << record << "," << index << "," << iteration << "," << csv_field(instruction) << "," << words << "," << timing << ",";
+        if (cc)
+            os << cc->best << "," << cc->cache << "," << cc->worst;
+        else
+            os << ",,";
+        os << "," << csv_field(note) << "\n";
+    };
+
+    if (r.model == 68060) {
+        for (size_t pos = 0; pos < r.t060.instructions.size(); ++pos) {
+            const auto& e = r.t060.instructions[pos];
+            const auto& inst = r.insts[pos % r.insts.size()];
+            std::ostringstream timing;
+            timing << e.cycle << "," << e.cycles << ",";
+            if (!e.branch)
+                timing << e.pipe;
+            timing << "," << e.stall << ",";
+            if (e.stall)
+                timing << e.stall_reg;
+            row("issue", std::to_string(pos % r.insts.size()), std::to_string(pos / r.insts.size()), instruction_text(inst), inst.num_words(), timing.str(), nullptr, r.soep_idle(pos));
+        }
+        if (r.ss.prologue_cycles != r.ss.prologue_iterations * r.ss.cycles_per_iteration())
+            row("warmup", "", std::to_string(r.ss.prologue_iterations), "", r.instruction_words, "," + std::to_string(r.ss.prologue_cycles) + ",,,", nullptr, "");
+        row("total", "", "", "", r.instruction_words, "," + to_string(r.ss.cycles_per_iteration()) + ",,,", nullptr, r.ss.exact ? "" : "approximate");
+    } else {
+        for (size_t i = 0; i < r.insts.size(); ++i) {
+            const auto& c = r.t020.instructions[i];
+            row("instruction", std::to_string(i), "", instruction_text(r.insts[i]), r.insts[i].num_words(), ",,,,", &c.cost, c.assumed_taken ? "assumed taken" : "");
+        }
+        row("total", "", "", "", r.instruction_words, ",,,,", &r.t020.total, "");
+    }
+}
+
+// Value of an integer option, e.g. "4" of "--fetch=4"
+int option_value(const std::string& arg, size_t prefix_len, int min_value, const char* what)
+{
+    const auto value = arg.substr(prefix_len);
+    errno = 0;
+    char* end;
+    const long n = std::strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end || errno == ERANGE || n < min_value || n > INT_MAX)
+        throw std::runtime_error { std::string { "Invalid " } + what + " " + value };
+    return static_cast<int>(n);
+}
+
+} // unnamed namespace
+
+bool parse_analysis_option(const std::string& arg, analysis_options& opts)
+{
+    auto has_prefix = [&](const char* prefix) {
+        return arg.compare(0, std::strlen(prefix), prefix) == 0;
+    };
+
+    if (arg.size() > 1 && arg[0] == '-' && std::isdigit(static_cast<unsigned char>(arg[1]))) {
+        int model = option_value(arg, 1, 0, "CPU model");
+        if (model < 68000)
+            model += 68000;
+        if (model != 68020 && model != 68060)
+            throw std::runtime_error { "Unsupported CPU model " + arg.substr(1) };
+        opts.model = model;
+    } else if (has_prefix("--format=")) {
+        const auto format = parse_report_format(arg.substr(9));
+        if (!format)
+            throw std::runtime_error { "Unsupported format " + arg.substr(9) };
+        opts.format = *format;
+    } else if (has_prefix("--unroll=")) {
+        opts.unroll = option_value(arg, 9, 0, "unroll count");
+    } else if (arg == "--profile") {
+        opts.profile = true;
+    } else if (has_prefix("--fetch=")) {
+        opts.cpu_060.fetch_bytes_per_cycle = option_value(arg, 8, 0, "fetch rate");
+    } else if (has_prefix("--ibuffer=")) {
+        opts.cpu_060.instruction_buffer_bytes = option_value(arg, 10, 0, "instruction buffer size");
+        if (opts.cpu_060.instruction_buffer_bytes < max_instruction_bytes)
+            throw std::runtime_error { "Instruction buffer must hold at least " + std::to_string(max_instruction_bytes) + " bytes" };
+    } else if (arg == "--dcache") {
+        opts.cpu_060.data_cache_bytes = 8192;
+    } else if (has_prefix("--dcache=")) {
+        opts.cpu_060.data_cache_bytes = option_value(arg, 9, 0, "data cache size");
+        if (opts.cpu_060.data_cache_bytes % data_cache_line_bytes)
+            throw std::runtime_error { "Invalid data cache size " + arg.substr(9) };
+    } else if (has_prefix("--dcache-ways=")) {
+        opts.cpu_060.data_cache_ways = option_value(arg, 14, 1, "data cache associativity");
+    } else if (has_prefix("--line-fill=")) {
+        opts.cpu_060.line_fill_cycles = option_value(arg, 12, 0, "line fill latency");
+    } else if (arg == "--no-write-allocate") {
+        opts.cpu_060.write_allocate = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::optional<report_format> parse_report_format(std::string_view name)
+{
+    if (name == "text")
+        return report_format::text;
+    if (name == "json")
+        return report_format::json;
+    if (name == "csv")
+        return report_format::csv;
+    return {};
+}
+
+std::string csv_field(std::string_view s)
+{
+    if (s.find_first_of(",\"\r\n") == std::string_view::npos)
+        return std::string { s };
+    std::string res { "\"" };
+    for (const char ch : s) {
+        if (ch == '"')
+            res.push_back('"');
+        res.push_back(ch);
+    }
+    res.push_back('"');
+    return res;
+}
+
+void analyse(instruction_view insts, const analysis_options& opts, std::ostream& os)
+{
+    switch (opts.format) {
+    case report_format::text:
+        analyse_text(insts, opts, os);
+        return;
+    case report_format::json:
+        analyse_json(report { insts, opts }, os);
+        return;
+    case report_format::csv:
+        analyse_csv(report { insts, opts }, os);
+        return;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef ANALYSIS_H_INCLUDED
+#define ANALYSIS_H_INCLUDED
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+#include <iosfwd>
+#include "packed_instruction.h"
+#include "cpu_model_060.h"
+
+enum class report_format {
+    text,
+    json,
+    csv,
+};
+
+// "text", "json" or "csv"
+std::optional<report_format> parse_report_format(std::string_view name);
+
+// Version of the json/csv report layout, incremented on incompatible changes
+constexpr int report_schema_version = 1;
+
+// Header line of csv reports (without newline)
+extern const char* const csv_report_header;
+
+// s as a csv field (quoted if needed)
+std::string csv_field(std::string_view s);
+
+struct analysis_options {
+    int model = 68060;
+    int unroll = 1; // Extra iterations shown (68060)
+    bool profile = false; // Add a stall/pairing profile to text reports (68060)
+    options_060 cpu_060;
+    report_format format = report_format::text;
+};
+
+// Applies a command line option (e.g. -68020, --unroll=N, --dcache) to opts, shared
+// by the command line and server requests. Returns false if arg isn't an analysis
+// option, throws if its value is invalid.
+bool parse_analysis_option(const std::string& arg, analysis_options& opts);
+
+// Runs the selected CPU model on a loop and writes the report to os
+void analyse(instruction_view insts, const analysis_options& opts, std::ostream& os);
+
+#endif
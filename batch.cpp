@@ -0,0 +1,140 @@
+#include "batch.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <stdexcept>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool wildcard_match(const char* pat, const char* str)
+{
+    for (; *pat; ++pat, ++str) {
+        if (*pat == '*') {
+            for (;; ++str) {
+                if (wildcard_match(pat + 1, str))
+                    return true;
+                if (!*str)
+                    return false;
+            }
+        }
+        if (!*str || (*pat != '?' && *pat != *str))
+            return false;
+    }
+    return !*str;
+}
+
+bool has_wildcard(const std::string& s)
+{
+    return s.find_first_of("*?") != std::string::npos;
+}
+
+bool is_source_file(const fs::path& p)
+{
+    const auto ext = p.extension();
+    return ext == ".asm" || ext == ".s";
+}
+
+} // unnamed namespace
+
+void parallel_for(size_t count, const std::function<void(size_t)>& fn, unsigned num_threads)
+{
+    if (!num_threads)
+        num_threads = std::max(1U, std::thread::hardware_concurrency());
+    if (num_threads > count)
+        num_threads = static_cast<unsigned>(count);
+    if (num_threads <= 1) {
+        for (size_t i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next { 0 };
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    size_t error_index = count;
+
+    auto worker = [&]() {
+        for (;;) {
+            const size_t i = next++;
+            if (i >= count)
+                return;
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock { error_mutex };
+                if (i < error_index) {
+                    error_index = i;
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < num_threads; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& t : threads)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+bool is_batch_source(const std::string& arg)
+{
+    return has_wildcard(arg) || fs::is_directory(arg);
+}
+
+std::vector<std::string> expand_sources(const std::vector<std::string>& args)
+{
+    std::vector<std::string> res;
+    for (const auto& arg : args) {
+        std::vector<std::string> files;
+        if (has_wildcard(arg)) {
+            const fs::path p { arg };
+            if (has_wildcard(p.parent_path().string()))
+                throw std::runtime_error { "Wildcards are only supported in the file name: " + arg };
+            const auto dir = p.has_parent_path() ? p.parent_path() : fs::path { "." };
+            const auto pattern = p.filename().string();
+            for (const auto& e : fs::directory_iterator { dir }) {
+                if (e.is_regular_file() && wildcard_match(pattern.c_str(), e.path().filename().string().c_str()))
+                    files.push_back((p.has_parent_path() ? e.path() : e.path().filename()).string());
+            }
+        } else if (fs::is_directory(arg)) {
+            for (const auto& e : fs::recursive_directory_iterator { arg }) {
+                if (e.is_regular_file() && is_source_file(e.path()))
+                    files.push_back(e.path().string());
+            }
+        } else {
+            files.push_back(arg);
+        }
+        std::sort(files.begin(), files.end());
+        res.insert(res.end(), files.begin(), files.end());
+    }
+    return res;
+}
+
+std::vector<batch_result> run_batch(const std::vector<std::string>& filenames, const std::function<void(const std::string& filename, std::ostream& os)>& process, unsigned num_threads)
+{
+    std::vector<batch_result> res(filenames.size());
+    parallel_for(filenames.size(), [&](size_t i) {
+        auto& r = res[i];
+        r.filename = filenames[i];
+        std::ostringstream oss;
+        try {
+            process(r.filename, oss);
+            r.ok = true;
+            r.output = oss.str();
+        } catch (const std::exception& e) {
+            r.ok = false;
+            r.output = e.what();
+        }
+    }, num_threads);
+    return res;
+}
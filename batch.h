@@ -0,0 +1,31 @@
+#ifndef BATCH_H_INCLUDED
+#define BATCH_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <iosfwd>
+
+// Calls fn(0), ..., fn(count-1) from num_threads worker threads (0 = one per hardware thread).
+// Work items are handed out one at a time so uneven items balance out.
+// If fn throws, the exception of the lowest index is rethrown once all workers are done.
+void parallel_for(size_t count, const std::function<void(size_t)>& fn, unsigned num_threads = 0);
+
+// Expands each argument to a sorted list of source files:
+// - Directories are searched recursively for .asm/.s files
+// - '*' and '?' are supported in the last path component
+// - Anything else is taken as a file name
+std::vector<std::string> expand_sources(const std::vector<std::string>& args);
+
+bool is_batch_source(const std::string& arg);
+
+struct batch_result {
+    std::string filename;
+    bool ok;
+    std::string output; // Error message if !ok
+};
+
+// Runs process for each file in parallel, results are returned in the order of filenames
+std::vector<batch_result> run_batch(const std::vector<std::string>& filenames, const std::function<void(const std::string& filename, std::ostream& os)>& process, unsigned num_threads = 0);
+
+#endif
@@ -1,10 +1,30 @@
 #ifndef CPU_MODEL_H
 #define CPU_MODEL_H
 
+#include "sim_events.h"
+
+// Cycle count of a loop split into warm-up iterations and the part that repeats
+struct steady_state {
+    int prologue_iterations;
+    int prologue_cycles;
+    int period_iterations;
+    int period_cycles;
+    bool exact; // false if the state didn't repeat within the iteration limit (period is then an average)
+
+    double cycles_per_iteration() const
+    {
+        return period_iterations ? static_cast<double>(period_cycles) / period_iterations : 0;
+    }
+};
+
 class cpu_model {
 public:
     virtual ~cpu_model() {}
     virtual double simulate(int unroll, bool print) = 0;
+    virtual double simulate(int unroll, event_sink& sink) = 0;
+    virtual steady_state find_steady_state(int max_iterations = 1000) = 0;
+    // The contents of the instruction vector the model was created with changed
+    virtual void instructions_changed() {}
 };
 
 #endif
@@ -1,37 +1,20 @@
 #include "cpu_model_020.h"
 #include "instruction.h"
 #include "util.h"
+#include "stats.h"
 #include <sstream>
+#include <numeric>
+#include <algorithm>
 
 // TODO: Pipeline simulation
 
-namespace {
-
-struct cycle_counts {
-    int best;
-    int cache;
-    int worst;
-
-    cycle_counts& operator+=(const cycle_counts& r)
-    {
-        best += r.best;
-        cache += r.cache;
-        worst += r.worst;
-        return *this;
-    }
-};
-
-cycle_counts operator+(const cycle_counts& l, const cycle_counts& r)
-{
-    cycle_counts cc = l;
-    return cc += r;
-}
-
 std::ostream& operator<<(std::ostream& os, const cycle_counts& cc)
 {
     return os << cc.best << "/" << cc.cache << "/" << cc.worst;
 }
 
+namespace {
+
 cycle_counts fetch_effective_address_cost(const ea& e, char opsize)
 {
     switch (e.val() >> ea_m_shift) {
@@ -45,8 +28,10 @@ cycle_counts fetch_effective_address_cost(const ea& e, char opsize)
     case ea_m_A_ind_pre:
         return { 3, 5, 5 };
     case ea_m_A_ind_disp16:
+    disp16:
         return { 3, 5, 6 };
     case ea_m_A_ind_index:
+    disp_index:
         return { 4, 7, 8 };
     case ea_m_Other:
         switch (e.val() & ea_xn_mask) {
@@ -54,8 +39,10 @@ cycle_counts fetch_effective_address_cost(const ea& e, char opsize)
             return { 3, 4, 6 };
         case ea_other_abs_l:
             return { 3, 4, 7 };
-        // case ea_other_pc_disp16:
-        // case ea_other_pc_index:
+        case ea_other_pc_disp16:
+            goto disp16;
+        case ea_other_pc_index:
+            goto disp_index;
         case ea_other_imm:
             if (opsize != 'l')
                 return { 0, 2, 3 };
@@ -178,8 +165,26 @@ cycle_counts move_cost_020(const instruction& i)
             // case ea_m_Other:
         }
         break;
+    case ea_m_A_ind_post:
+        switch (dst_ea_m) {
+        case ea_m_Dn:
+            return { 4, 6, 7 };
+        case ea_m_An:
+            return { 4, 6, 7 };
+        case ea_m_A_ind:
+            return { 6, 7, 9 };
+        case ea_m_A_ind_post:
+            return { 6, 7, 9 };
+        case ea_m_A_ind_pre:
+            return { 6, 7, 9 };
+        case ea_m_A_ind_disp16:
+            return { 6, 7, 11 };
+        case ea_m_A_ind_index:
+            return { 8, 9, 11 };
+            // case ea_m_Other:
+        }
+        break;
     //case ea_m_A_ind_pre:
-    // case ea_m_A_ind_post:
     case ea_m_A_ind_disp16: // Also for disp16(pc)
     disp16:
         switch (dst_ea_m) {
@@ -258,6 +263,46 @@ cycle_counts move_cost_020(const instruction& i)
     throw std::runtime_error { oss.str() };
 }
 
+cycle_counts calculate_effective_address_cost(const ea& e)
+{
+    // 68020UM calculate effective address table
+    switch (e.val() >> ea_m_shift) {
+    case ea_m_Dn:
+    case ea_m_An:
+        return {};
+    case ea_m_A_ind:
+    case ea_m_A_ind_post:
+    case ea_m_A_ind_pre:
+        return { 0, 2, 2 };
+    case ea_m_A_ind_disp16:
+    disp16:
+        return { 1, 2, 3 };
+    case ea_m_A_ind_index:
+    disp_index:
+        return { 2, 4, 5 };
+    case ea_m_Other:
+        switch (e.val() & ea_xn_mask) {
+        case ea_other_abs_w:
+            return { 1, 2, 3 };
+        case ea_other_abs_l:
+            return { 1, 2, 4 };
+        case ea_other_pc_disp16:
+            goto disp16;
+        case ea_other_pc_index:
+            goto disp_index;
+        }
+    }
+    std::ostringstream oss;
+    oss << "TODO: calculate_effective_address_cost (020) for " << e;
+    throw std::runtime_error { oss.str() };
+}
+
+cycle_counts lea_cost_020(const instruction& i)
+{
+    // LEA <ea>,An plus the calculate effective address time
+    return cycle_counts { 2, 2, 3 } + calculate_effective_address_cost(i.arg(0));
+}
+
 cycle_counts arit_cost_020(const instruction& i)
 {
     assert(num_ea(i.op()) == 2);
@@ -272,7 +317,8 @@ cycle_counts arit_cost_020(const instruction& i)
     return base_cost + fetch_effective_address_cost(i);
 }
 
-cycle_counts cost_020(const instruction& i)
+// taken: Direction of a branch (or dbra)
+cycle_counts cost_020(const instruction& i, bool taken)
 {
     const bool is_imm = num_ea(i.op()) && i.arg(0).val() == ea_immediate;
 
@@ -281,6 +327,8 @@ cycle_counts cost_020(const instruction& i)
         return move_cost_020(i);
     case opcode::moveq:
         return { 0, 2, 3 };
+    case opcode::lea:
+        return lea_cost_020(i);
     case opcode::swap:
         return { 1, 4, 4 };
     case opcode::neg:
@@ -323,9 +371,15 @@ cycle_counts cost_020(const instruction& i)
     }
 
     if (is_branch(i.op()) || i.op() == opcode::dbra) {
-        // Assume taken (otherwise Bcc.B 1/4/5 Bcc.W 3/6/7 Bcc.L 3/6/9)
+        if (taken)
+            return { 3, 6, 9 };
+        switch (i.opsize()) {
+        case 'b':
+            return { 1, 4, 5 };
+        case 'w':
+            return { 3, 6, 7 };
+        }
         return { 3, 6, 9 };
-
     }
 
     if (is_shift_rot(i.op()) && num_ea(i.op()) == 2 && (i.arg(1).val() >> ea_m_shift) == ea_m_Dn) {
@@ -349,45 +403,112 @@ cycle_counts cost_020(const instruction& i)
     throw std::runtime_error { oss.str() };
 }
 
+// Prints the events in the format used by simulate(unroll, true)
+class text_sink {
+public:
+    explicit text_sink(std::ostream& os)
+        : os_ { os }
+    {
+    }
+
+    void on(const cost_event& e)
+    {
+        os_ << "\t" << with_width(e.inst, print_width) << "\t; " << e.cost;
+        if (e.assumed_taken)
+            os_ << " (assuming taken)";
+        else if (e.inst.branch().length)
+            os_ << (e.taken ? " (taken)" : " (not taken)");
+        os_ << "\n";
+    }
+
+    void on(const end_event& e)
+    {
+        os_ << "\t" << std::string(print_width, ' ') << "\t; " << e.total << "\n";
+    }
+
+private:
+    static constexpr size_t print_width = 40;
+    std::ostream& os_;
+};
+
 } // unnamed namespace
 
 class cpu_model_020 : public cpu_model
 {
 public:
-    explicit cpu_model_020(std::ostream& os, const std::vector<instruction>& instructions)
+    explicit cpu_model_020(std::ostream& os, instruction_view instructions)
         : os_ { os }
         , instructions_ { instructions }
     {
     }
 
-    double simulate(int unroll, bool print) override;
+    double simulate(int unroll, bool print) override
+    {
+        if (print) {
+            text_sink sink { os_ };
+            return run(unroll, sink);
+        }
+        null_sink sink;
+        return run(unroll, sink);
+    }
+
+    double simulate(int unroll, event_sink& sink) override
+    {
+        return run(unroll, sink);
+    }
+
+    steady_state find_steady_state(int max_iterations) override
+    {
+        // Iterations only differ in the directions of annotated branches, so the costs
+        // repeat once all their patterns do
+        int64_t period = 1;
+        for (size_t i = 0; i < instructions_.size(); ++i) {
+            if (const int length = instructions_[i].branch().length)
+                period = std::lcm(period, static_cast<int64_t>(length));
+        }
+        const int iterations = static_cast<int>(std::min(period, static_cast<int64_t>(max_iterations)));
+        const int cycles = static_cast<int>(simulate(iterations - 1, false));
+        return { 0, 0, iterations, cycles, period <= max_iterations };
+    }
 
 public:
     std::ostream& os_;
-    const std::vector<instruction>& instructions_;
+    instruction_view instructions_;
+
+    template<typename Sink>
+    double run(int unroll, Sink& sink);
 };
 
-double cpu_model_020::simulate(int unroll, bool print)
+template<typename Sink>
+double cpu_model_020::run(int unroll, Sink& sink)
 {
-    constexpr size_t print_width = 40;
+    stat_timer timer { stat_phase::simulate_020 };
+    timer.items(instructions_.size() * (unroll + 1));
     cycle_counts total {};
-    for (const auto& inst : instructions_) {
-        const auto cost = cost_020(inst);
-        if (print) {
-            os_ << "\t" << with_width(inst, print_width) << "\t; " << cost;
-            if (is_branch(inst.op()) || inst.op() == opcode::dbra)
-                os_ << " (assuming taken)";
-            os_ << "\n";
+    int cycles = 0;
+    for (int iteration = 0; iteration <= unroll; ++iteration) {
+        cycle_counts iteration_total {};
+        for (size_t pos = 0; pos < instructions_.size(); ++pos) {
+            const auto& inst = instructions_[pos];
+            const bool branch = is_branch(inst.op()) || inst.op() == opcode::dbra;
+            const bool taken = branch && inst.branch().is_taken(iteration);
+            const auto cost = cost_020(inst, taken);
+            if (!iteration)
+                sink.on(cost_event { pos, inst, cost, branch && !inst.branch().length, taken });
+            iteration_total += cost;
         }
-        total += cost;
+        if (!iteration)
+            total = iteration_total;
+        cycles += iteration_total.cache;
     }
-    if (print)
-        os_ << "\t" << std::string(print_width, ' ') << "\t; " << total << "\n";
-    return total.cache * (unroll + 1);
+    sink.on(end_event { unroll, cycles, total });
+    return cycles;
 }
 
 
-std::unique_ptr<cpu_model> make_cpu_model_020(std::ostream& os, const std::vector<instruction>& instructions)
+std::unique_ptr<cpu_model> make_cpu_model_020(std::ostream& os, instruction_view instructions)
 {
+    stat_timer timer { stat_phase::construct_020 };
+    timer.items(instructions.size());
     return std::make_unique<cpu_model_020>(os, instructions);
 }
@@ -2,12 +2,11 @@
 #define CPU_MODEL_020_H
 
 #include "cpu_model.h"
+#include "packed_instruction.h"
 #include <vector>
 #include <memory>
 #include <iosfwd>
 
-class instruction;
-
-std::unique_ptr<cpu_model> make_cpu_model_020(std::ostream& os, const std::vector<instruction>& instructions);
+std::unique_ptr<cpu_model> make_cpu_model_020(std::ostream& os, instruction_view instructions);
 
 #endif
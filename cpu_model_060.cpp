@@ -1,15 +1,16 @@
 #include "cpu_model_060.h"
 #include "instruction.h"
 #include "util.h"
+#include "stats.h"
 #include <ostream>
+#include <map>
+#include <algorithm>
 
 // TODO: Model constraits
 // - Whether the instruction can be dispatched in the sOEP
 // - Conlficts
-// - When a register is ready for addressing
-// - Ifetch: https://eab.abime.net/showthread.php?t=111352&page=2 https://eab.abime.net/showthread.php?t=58743 (also info on branch prediction)
+// - Ifetch: Alignment and the branch cache (https://eab.abime.net/showthread.php?t=111352&page=2 https://eab.abime.net/showthread.php?t=58743)
 // - Indirect address modes (not supported probably ever)
-// - Handle e.g. add.l (a0),(a1) // 2 reads + write
 // etc.
 
 // d4=1
@@ -46,253 +47,1102 @@ bool soep_ea_ok(const ea& e)
     throw std::runtime_error(oss.str());
 }
 
+// Cycles taken by branches that aren't folded
+constexpr int branch_not_taken_cycles = 1; // Correctly predicted not taken
+constexpr int branch_mispredict_cycles = 7;
+
+constexpr uint32_t reg_bit(eareg r)
+{
+    return 1U << static_cast<int>(r);
+}
+
+// Operand memory reference, for tracking the addresses seen by the data cache
+struct data_ref {
+    static constexpr int8_t absolute = -1;
+    static constexpr int8_t untracked = -2; // Indexed/PC relative: The address isn't known, assumed to hit
+
+    int8_t areg; // Base register (0-7 for a0-a7) or one of the above
+    int8_t size;
+    int8_t pre; // Added to An before the access (-(An))
+    int8_t post; // Added to An after the access ((An)+)
+    bool store;
+    int32_t disp; // Displacement (or absolute address)
+};
+
+// How an instruction changes the address register it writes (if any)
+enum class areg_update : uint8_t {
+    fresh, // Points to a buffer not seen before (e.g. loaded from memory)
+    add, // Immediate added
+    copy, // move.l An,Am or lea d16(An),Am (src plus value)
+    absolute, // lea addr,An
+};
+
+struct data_refs {
+    uint8_t count;
+    data_ref ref[2];
+    areg_update update;
+    int8_t src; // Register copied
+    int32_t value; // Immediate added, displacement or absolute address
+};
+
+int operand_bytes(const instruction& i)
+{
+    switch (i.opsize()) {
+    case 'b':
+        return 1;
+    case 'w':
+        return 2;
+    }
+    return 4;
+}
+
+void decode_data_ref(const instruction& i, int n, bool store, data_refs& d)
+{
+    const auto& e = i.arg(n);
+    if (!e.is_mem())
+        return;
+    data_ref r {};
+    r.size = static_cast<int8_t>(operand_bytes(i));
+    r.store = store;
+    const int reg = e.val() & ea_xn_mask;
+    // The stack pointer is kept word aligned
+    const int8_t step = r.size == 1 && reg == 7 ? 2 : r.size;
+    switch (e.val() >> ea_m_shift) {
+    case ea_m_A_ind:
+        r.areg = static_cast<int8_t>(reg);
+        break;
+    case ea_m_A_ind_post:
+        r.areg = static_cast<int8_t>(reg);
+        r.post = step;
+        break;
+    case ea_m_A_ind_pre:
+        r.areg = static_cast<int8_t>(reg);
+        r.pre = static_cast<int8_t>(-step);
+        break;
+    case ea_m_A_ind_disp16:
+        r.areg = static_cast<int8_t>(reg);
+        r.disp = static_cast<int32_t>(e.extra());
+        break;
+    case ea_m_Other:
+        if ((e.val() & ea_xn_mask) == ea_other_abs_w) {
+            r.areg = data_ref::absolute;
+            r.disp = static_cast<int16_t>(e.extra());
+            break;
+        }
+        if ((e.val() & ea_xn_mask) == ea_other_abs_l) {
+            r.areg = data_ref::absolute;
+            r.disp = static_cast<int32_t>(e.extra());
+            break;
+        }
+        r.areg = data_ref::untracked;
+        break;
+    default:
+        r.areg = data_ref::untracked;
+        break;
+    }
+    d.ref[d.count++] = r;
+}
+
+data_refs decode_data_refs(const instruction& i)
+{
+    data_refs d {};
+    const auto op = i.op();
+    if (is_branch(op))
+        return d;
+    if (op == opcode::lea) {
+        const auto& e = i.arg(0);
+        switch (e.val() >> ea_m_shift) {
+        case ea_m_A_ind:
+        case ea_m_A_ind_disp16:
+            d.update = areg_update::copy;
+            d.src = static_cast<int8_t>(e.val() & ea_xn_mask);
+            d.value = ea_has_extra(e.val()) ? static_cast<int32_t>(e.extra()) : 0;
+            break;
+        case ea_m_Other:
+            if (e.val() == (ea_m_Other << ea_m_shift | ea_other_abs_w) || e.val() == (ea_m_Other << ea_m_shift | ea_other_abs_l)) {
+                d.update = areg_update::absolute;
+                d.value = (e.val() & ea_xn_mask) == ea_other_abs_w ? static_cast<int16_t>(e.extra()) : static_cast<int32_t>(e.extra());
+            }
+            break;
+        }
+        return d;
+    }
+
+    // Read-modify-write operands are read first (the write then hits the same line)
+    switch (num_ea(op)) {
+    case 1:
+        decode_data_ref(i, 0, !is_rmw(op) && op != opcode::tst, d);
+        break;
+    case 2:
+        decode_data_ref(i, 0, false, d);
+        decode_data_ref(i, 1, op == opcode::move, d);
+        break;
+    }
+
+    if (const auto r = i.execution_result_reg(); r && is_areg(*r)) {
+        const auto& src = i.arg(0);
+        if ((op == opcode::addq || op == opcode::subq || op == opcode::add || op == opcode::sub) && src.val() == ea_immediate) {
+            d.update = areg_update::add;
+            d.value = op == opcode::addq || op == opcode::add ? static_cast<int32_t>(src.extra()) : -static_cast<int32_t>(src.extra());
+        } else if (op == opcode::move && i.opsize() == 'l' && (src.val() >> ea_m_shift) == ea_m_An) {
+            d.update = areg_update::copy;
+            d.src = static_cast<int8_t>(src.val() & ea_xn_mask);
+        }
+    }
+    return d;
+}
+
+// Register masks (bit n = eareg n) and properties of one instruction, computed once per loop
+struct decoded_instruction {
+    oep_class classi;
+    uint8_t cycles;
+    uint8_t mem_cycles;
+    uint8_t bytes;
+    int8_t result_reg; // -1 if none
+    int8_t bad_soep_ea; // Index of first EA not allowed in the sOEP (-1 if none)
+    bool is_branch;
+    branch_pattern branch;
+    bool forwards_ab; // Result can be forwarded to sOEP.A/B
+    bool early_result; // Result available to the AGU a cycle early (10.2.3)
+    uint32_t def;
+    uint32_t agu_def; // Address registers updated by the AGU ((An)+/-(An))
+    uint32_t use_ab;
+    uint32_t use_base;
+    uint32_t use_index;
+    uint32_t agu_slow; // Address registers that need 3 cycles between change and use
+    data_refs data;
+};
+
+void decode_ea(const ea& e, decoded_instruction& d)
+{
+    switch (e.val() >> ea_m_shift) {
+    case ea_m_Dn:
+        d.use_ab |= 1U << (e.val() & ea_xn_mask);
+        return;
+    case ea_m_An:
+        d.use_ab |= 1U << (8 + (e.val() & ea_xn_mask));
+        return;
+    case ea_m_A_ind_post:
+    case ea_m_A_ind_pre:
+        d.agu_def |= 1U << (8 + (e.val() & ea_xn_mask));
+        [[fallthrough]];
+    case ea_m_A_ind:
+    case ea_m_A_ind_disp16:
+        d.use_base |= 1U << (8 + (e.val() & ea_xn_mask));
+        return;
+    case ea_m_A_ind_index:
+    index: {
+        const auto bew = get_brief_extension_word(e);
+        if (bew.base != eareg::pc)
+            d.use_base |= reg_bit(bew.base);
+        d.use_index |= reg_bit(bew.index);
+        if (!(bew.long_size && (bew.scale == 1 || bew.scale == 4)))
+            d.agu_slow |= reg_bit(bew.index);
+        return;
+    }
+    case ea_m_Other:
+        switch (e.val() & ea_xn_mask) {
+        case ea_other_abs_w:
+        case ea_other_abs_l:
+        case ea_other_pc_disp16:
+        case ea_other_imm:
+            return;
+        case ea_other_pc_index:
+            goto index;
+        }
+    }
+    std::ostringstream oss;
+    oss << "TODO: implement decode_ea for " << e;
+    throw std::runtime_error(oss.str());
+}
+
+decoded_instruction decode(const instruction& i)
+{
+    decoded_instruction d {};
+    d.classi = i.oep_classify();
+    d.cycles = static_cast<uint8_t>(i.cylces());
+    d.mem_cycles = static_cast<uint8_t>(i.mem_cycles());
+    d.bytes = static_cast<uint8_t>(i.num_words() * 2);
+    const auto r = i.execution_result_reg();
+    d.result_reg = r ? static_cast<int8_t>(*r) : -1;
+    d.def = r ? reg_bit(*r) : 0;
+    d.bad_soep_ea = -1;
+    d.is_branch = is_branch(i.op());
+    d.branch = i.branch();
+    // move.l ...,Rx can be forwarded to sOEP.A/B
+    // moveq isn't documented but can as well, also seems like clr.l can, maybe also lea
+    d.forwards_ab = (i.op() == opcode::move && i.opsize() == 'l') || i.op() == opcode::moveq;
+    // 10.2.3: move.l and lea results are also available to the AGU a cycle early
+    d.early_result = d.forwards_ab || i.op() == opcode::lea;
+    for (int n = 0; n < num_ea(i.op()); ++n) {
+        decode_ea(i.arg(n), d);
+        if (d.bad_soep_ea < 0 && !soep_ea_ok(i.arg(n)))
+            d.bad_soep_ea = static_cast<int8_t>(n);
+    }
+    // The result wins if the instruction also updates its destination with (An)+/-(An)
+    d.agu_def &= ~d.def;
+    d.data = decode_data_refs(i);
+    return d;
+}
+
+// Structure-of-arrays form of decoded_instruction
+struct decoded_stream {
+    std::vector<oep_class> classi;
+    std::vector<uint8_t> cycles;
+    std::vector<uint8_t> mem_cycles;
+    std::vector<uint8_t> bytes;
+    std::vector<int8_t> result_reg;
+    std::vector<int8_t> bad_soep_ea;
+    std::vector<uint8_t> is_branch;
+    std::vector<branch_pattern> branch;
+    std::vector<uint8_t> forwards_ab;
+    std::vector<uint8_t> early_result;
+    std::vector<uint32_t> def;
+    std::vector<uint32_t> agu_def;
+    std::vector<uint32_t> use_ab;
+    std::vector<uint32_t> use_base;
+    std::vector<uint32_t> use_index;
+    std::vector<uint32_t> agu_slow;
+    std::vector<data_refs> data;
+
+    void push_back(const decoded_instruction& d)
+    {
+        classi.push_back(d.classi);
+        cycles.push_back(d.cycles);
+        mem_cycles.push_back(d.mem_cycles);
+        bytes.push_back(d.bytes);
+        result_reg.push_back(d.result_reg);
+        bad_soep_ea.push_back(d.bad_soep_ea);
+        is_branch.push_back(d.is_branch);
+        branch.push_back(d.branch);
+        forwards_ab.push_back(d.forwards_ab);
+        early_result.push_back(d.early_result);
+        def.push_back(d.def);
+        agu_def.push_back(d.agu_def);
+        use_ab.push_back(d.use_ab);
+        use_base.push_back(d.use_base);
+        use_index.push_back(d.use_index);
+        agu_slow.push_back(d.agu_slow);
+        data.push_back(d.data);
+    }
+
+    void set(size_t i, const decoded_instruction& d)
+    {
+        classi[i] = d.classi;
+        cycles[i] = d.cycles;
+        mem_cycles[i] = d.mem_cycles;
+        bytes[i] = d.bytes;
+        result_reg[i] = d.result_reg;
+        bad_soep_ea[i] = d.bad_soep_ea;
+        is_branch[i] = d.is_branch;
+        branch[i] = d.branch;
+        forwards_ab[i] = d.forwards_ab;
+        early_result[i] = d.early_result;
+        def[i] = d.def;
+        agu_def[i] = d.agu_def;
+        use_ab[i] = d.use_ab;
+        use_base[i] = d.use_base;
+        use_index[i] = d.use_index;
+        agu_slow[i] = d.agu_slow;
+        data[i] = d.data;
+    }
+
+    void truncate(size_t n)
+    {
+        classi.resize(n);
+        cycles.resize(n);
+        mem_cycles.resize(n);
+        bytes.resize(n);
+        result_reg.resize(n);
+        bad_soep_ea.resize(n);
+        is_branch.resize(n);
+        branch.resize(n);
+        forwards_ab.resize(n);
+        early_result.resize(n);
+        def.resize(n);
+        agu_def.resize(n);
+        use_ab.resize(n);
+        use_base.resize(n);
+        use_index.resize(n);
+        agu_slow.resize(n);
+        data.resize(n);
+    }
+};
+
+} // unnamed namespace
+
+void print_reason(std::ostream& os, const soep_check& c, const instruction& p, const instruction& s)
+{
+    switch (c.reason) {
+    case soep_reason::none:
+        break;
+    case soep_reason::fetch:
+        os << s.op() << " is not in the instruction buffer yet";
+        return;
+    case soep_reason::soep_class:
+        os << s.op() << " is " << s.oep_classify();
+        return;
+    case soep_reason::poep_class:
+        os << p.op() << " is " << p.oep_classify();
+        return;
+    case soep_reason::soep_cycles:
+        os << s.op() << " takes " << s.cylces() << " cycles";
+        return;
+    case soep_reason::soep_ea:
+        os << s.arg(c.arg) << " is not an allowable EA";
+        return;
+    case soep_reason::both_mem:
+        os << s.op() << " also uses memory cycle";
+        return;
+    case soep_reason::multi_mem:
+        os << s.op() << " uses more than one memory cycle";
+        return;
+    case soep_reason::reg_conflict:
+        os << s << " needs " << c.reg;
+        return;
+    }
+    os << "soep_reason{" << static_cast<int>(c.reason) << "}";
+}
+
+std::ostream& operator<<(std::ostream& os, oep o)
+{
+    switch (o) {
+    case oep::poep:
+        return os << "pOEP";
+    case oep::soep:
+        return os << "sOEP";
+    }
+    return os << "oep{" << static_cast<int>(o) << "}";
+}
+
+namespace {
+
+// Prints the events in the format used by simulate(unroll, true)
+class text_sink final : public event_sink {
+public:
+    explicit text_sink(std::ostream& os)
+        : os_ { os }
+    {
+    }
+
+    void on(const dispatch_event& e) override
+    {
+        if (e.pipe == oep::poep) {
+            os_ << "\t; Cycle " << e.cycle;
+            if (e.cycles > 1)
+                os_ << "-" << (e.cycle + e.cycles - 1);
+            os_ << "\n";
+            poep_cycle_ = e.cycle + e.stall;
+        }
+        os_ << "\t" << with_width(e.inst, print_width) << "; " << e.pipe;
+        if (e.pipe == oep::soep && e.cycle != poep_cycle_)
+            os_ << " (cycle " << e.cycle << ")";
+        os_ << "\n";
+    }
+
+    void on(const stall_event& e) override
+    {
+        os_ << "\t; " << e.pipe << " Change/use stall for " << e.cycles << " cycles waiting for " << e.reg << "\n";
+    }
+
+    void on(const fetch_stall_event& e) override
+    {
+        os_ << "\t; Instruction fetch stall for " << e.cycles << " cycles (" << e.buffered << " bytes buffered)\n";
+    }
+
+    void on(const data_cache_miss_event& e) override
+    {
+        os_ << "\t; " << e.pipe << " Data cache miss, " << e.misses << " line fill(s) stalling for " << e.cycles << " cycles\n";
+    }
+
+    void on(const soep_idle_event& e) override
+    {
+        os_ << "\t; sOEP idle because ";
+        print_reason(os_, e.check, e.poep_inst, e.soep_inst);
+        os_ << "\n";
+    }
+
+    void on(const branch_event& e) override
+    {
+        os_ << "\t; Branch " << (e.taken ? "taken" : "not taken");
+        if (!e.inst.branch().length)
+            os_ << " (assumed)";
+        os_ << ", branch cache " << (e.cache_hit ? "hit" : "miss") << ", ";
+        os_ << (e.taken == e.predicted_taken ? "correctly predicted" : "mispredicted") << " (taking " << e.cycles << " cycles)\n";
+        os_ << "\t" << with_width(e.inst, print_width) << "\n";
+    }
+
+    void on(const cycle_event&) override
+    {
+    }
+
+    void on(const end_event& e) override
+    {
+        os_ << "\n\n";
+        os_ << e.cycles << " cycles";
+        if (e.unroll > 0)
+            os_ << " " << (static_cast<double>(e.cycles) / (e.unroll + 1)) << " per iteration";
+        os_ << "\n";
+    }
+
+private:
+    static constexpr size_t print_width = 40;
+    std::ostream& os_;
+    int poep_cycle_ = 0; // Issue cycle of the last pOEP instruction
+};
+
 } // unnamed namespace
 
 class cpu_model_060 : public cpu_model {
 public:
-    explicit cpu_model_060(std::ostream& os, const std::vector<instruction>& instructions)
+    explicit cpu_model_060(std::ostream& os, instruction_view instructions, const options_060& opts = {})
         : os_ { os }
         , instructions_ { instructions }
+        , opts_ { opts }
+    {
+        instructions_changed();
+    }
+
+    double simulate(int unroll, bool print) override
+    {
+        if (print) {
+            text_sink sink { os_ };
+            return run(unroll, sink);
+        }
+        null_sink sink;
+        return run(unroll, sink);
+    }
+
+    double simulate(int unroll, event_sink& sink) override
     {
+        return run(unroll, sink);
     }
 
-    double simulate(int unroll, bool print) override;
+    steady_state find_steady_state(int max_iterations) override;
+
+    void instructions_changed() override
+    {
+        n_ = instructions_.size();
+        decoded_.truncate(0);
+        branches_.clear();
+        for (size_t i = 0; i < instructions_.size(); ++i) {
+            decoded_.push_back(decode(instructions_[i]));
+            if (decoded_.is_branch[i])
+                branches_.push_back(i);
+        }
+    }
+
+    // Simulates one pass (unroll 0) after instructions_ changed from index first_changed onwards.
+    // Only the part after the last saved state before first_changed is simulated (and reported
+    // to sink), returns the position simulation restarted from.
+    size_t resimulate(size_t first_changed, event_sink& sink);
+
+    // Streaming: instructions_ is a window where the instruction at stream position pos is
+    // in slot pos % stream_window. Call stream_push once the instruction at end_ is stored.
+    static constexpr size_t stream_window = 2;
+    void start_stream();
+    void stream_push(event_sink& sink);
+    int finish_stream(event_sink& sink);
+
+    size_t stream_end() const
+    {
+        return end_;
+    }
 
 private:
+    // How soon the AGU can use a changed register
+    enum class change_kind : uint8_t {
+        result, // Written by the execute stage
+        early, // Result that is available a cycle early (10.2.3)
+        agu, // Updated by the AGU itself ((An)+/-(An)), no stall
+    };
     struct reg_change {
         int cycle;
-        const instruction* inst;
+        size_t pos; // Position of the instruction in the instruction stream
+        change_kind kind;
     };
     struct change_use_stall {
         eareg reg;
         int cycles;
+        size_t producer;
     };
+    struct branch_cache_entry {
+        size_t address; // Index of the branch in the loop (or stream position), no_branch if unused
+        uint8_t state; // 2-bit counter, predicted taken if 2 or more
+    };
+    static constexpr size_t no_branch = SIZE_MAX;
+    // Symbolic address, regions are separate buffers (0: absolute addresses)
+    struct data_address {
+        uint32_t region;
+        uint32_t offset;
+    };
+    static constexpr uint64_t no_line = UINT64_MAX;
 
     std::ostream& os_;
-    const std::vector<instruction>& instructions_;
+    instruction_view instructions_;
+    options_060 opts_;
+    size_t n_; // instructions_.size()
+    decoded_stream decoded_;
+    uint32_t changed_regs_; // Registers in last_register_change_ with a valid entry
     int cycle_;
     int unroll_;
     size_t pos_;
+    size_t end_; // Position after the last instruction to simulate
+    int fetch_buffer_; // Bytes in the instruction buffer at cycle_ (negative if the IFU is behind)
+    bool streaming_;
+    std::vector<branch_cache_entry> branch_cache_;
+    std::vector<size_t> branches_; // Indices of the branches in instructions_
+    std::vector<uint64_t> data_cache_; // Line addresses, by set, most recently used first (empty if not modelled)
+    size_t data_cache_ways_;
+    data_address areg_address_[8]; // a0..a7
+    uint32_t next_region_;
     reg_change last_register_change_[16]; // d0..d7/a0..a7
 
+    // Simulation state at the start of a dispatch group
+    struct snapshot {
+        size_t pos;
+        int cycle;
+        int fetch_buffer;
+        uint32_t changed_regs;
+        reg_change last_register_change[16];
+    };
+    std::vector<snapshot> snapshots_; // Only kept by resimulate
+
     bool done() const
     {
-        return pos_ == (unroll_ + 1) * instructions_.size();
+        return pos_ == end_;
     }
 
-    const instruction* peek() const
+    // Index of the next instruction (or -1 if done)
+    ptrdiff_t peek() const
     {
-        return !done() ? &instructions_[pos_ % instructions_.size()] : nullptr;
+        return !done() ? static_cast<ptrdiff_t>(pos_ % n_) : -1;
     }
 
-    const instruction& get()
+    size_t get()
     {
         assert(!done());
-        return instructions_[pos_++ % instructions_.size()];
+        return pos_++ % n_;
     }
 
-    std::string soep_ok(const instruction& p, const instruction& s) const;
-    void update_register_change(const instruction& i);
-    change_use_stall check_change_use(const instruction& i) const;
-    change_use_stall check_change_use(const ea& e) const;
-    change_use_stall calc_stall(const eareg& e, int cycles) const;
+    void reset(int unroll);
+    template<typename Sink>
+    double run(int unroll, Sink& sink);
+    template<typename Sink>
+    void step(Sink& sink);
+    template<typename Sink>
+    void branch(size_t pos, size_t idx, const instruction& inst, Sink& sink);
+    std::vector<int> state_key() const;
+    soep_check soep_ok(size_t p, size_t s) const;
+    void update_register_change(size_t i, int agu_cycle, int result_cycle);
+    change_use_stall check_change_use(size_t i) const;
+    int access_data(size_t i, int& misses);
+    bool data_cache_hit(uint64_t line, bool store);
+
+    // Bytes in the instruction buffer after cycles more cycles
+    int buffered_after(int cycles) const
+    {
+        if (!opts_.fetch_bytes_per_cycle)
+            return opts_.instruction_buffer_bytes;
+        return std::min(opts_.instruction_buffer_bytes, fetch_buffer_ + cycles * opts_.fetch_bytes_per_cycle);
+    }
+
+    // Cycles from now until bytes are in the instruction buffer, at least min_cycles
+    int fetch_ready(int bytes, int min_cycles) const
+    {
+        const int missing = bytes - buffered_after(min_cycles);
+        if (missing <= 0)
+            return min_cycles;
+        return min_cycles + (missing + opts_.fetch_bytes_per_cycle - 1) / opts_.fetch_bytes_per_cycle;
+    }
 };
 
-double cpu_model_060::simulate(int unroll, bool print)
+template<typename Sink>
+double cpu_model_060::run(int unroll, Sink& sink)
+{
+    stat_timer timer { stat_phase::simulate_060 };
+    reset(unroll);
+    while (!done())
+        step(sink);
+    timer.items(pos_);
+    sink.on(end_event { unroll, cycle_ - 1, {} });
+    return static_cast<double>(cycle_ - 1) / (unroll + 1);
+}
+
+steady_state cpu_model_060::find_steady_state(int max_iterations)
+{
+    stat_timer timer { stat_phase::steady_state_060 };
+    const size_t n = instructions_.size();
+    if (!n)
+        return { 0, 0, 1, 0, true };
+
+    // The simulation is deterministic, so once the state at the start of an iteration
+    // repeats the following iterations repeat as well.
+    struct boundary {
+        int iteration;
+        int cycle;
+    };
+    std::map<std::vector<int>, boundary> seen;
+    boundary second {}, last {};
+    reset(max_iterations - 1);
+    null_sink sink;
+    size_t next_iteration = 0;
+    while (!done()) {
+        if (pos_ / n >= next_iteration) {
+            const boundary b { static_cast<int>(pos_ / n), cycle_ };
+            const auto [it, inserted] = seen.insert({ state_key(), b });
+            if (!inserted) {
+                timer.items(pos_);
+                return { it->second.iteration, it->second.cycle - 1, b.iteration - it->second.iteration, b.cycle - it->second.cycle, true };
+            }
+            if (!second.iteration && b.iteration)
+                second = b;
+            last = b;
+            next_iteration = b.iteration + 1;
+        }
+        step(sink);
+    }
+
+    // No repeating state found, average the iterations after the first one
+    timer.items(pos_);
+    if (last.iteration <= second.iteration)
+        return { 0, 0, max_iterations, cycle_ - 1, false };
+    return { second.iteration, second.cycle - 1, last.iteration - second.iteration, last.cycle - second.cycle, false };
+}
+
+size_t cpu_model_060::resimulate(size_t first_changed, event_sink& sink)
+{
+    n_ = instructions_.size();
+    decoded_.truncate(first_changed);
+    for (size_t i = first_changed; i < instructions_.size(); ++i)
+        decoded_.push_back(decode(instructions_[i]));
+
+    // A dispatch group starting before first_changed can still look at it (when trying
+    // to pair), so the state saved at its start is the last one that is still valid.
+    // The branch cache isn't saved: In one pass each branch is only seen once, so it
+    // always misses, and reset has cleared the entries of the previous simulation.
+    // (The data cache isn't modelled by the incremental model.)
+    while (!snapshots_.empty() && snapshots_.back().pos >= first_changed)
+        snapshots_.pop_back();
+    reset(0);
+    if (!snapshots_.empty()) {
+        const auto& s = snapshots_.back();
+        pos_ = s.pos;
+        cycle_ = s.cycle;
+        fetch_buffer_ = s.fetch_buffer;
+        changed_regs_ = s.changed_regs;
+        std::copy(std::begin(s.last_register_change), std::end(s.last_register_change), last_register_change_);
+        snapshots_.pop_back();
+    }
+
+    const size_t start = pos_;
+    while (!done()) {
+        snapshots_.push_back({ pos_, cycle_, fetch_buffer_, changed_regs_, {} });
+        std::copy(std::begin(last_register_change_), std::end(last_register_change_), snapshots_.back().last_register_change);
+        step(sink);
+    }
+    sink.on(end_event { 0, cycle_ - 1, {} });
+    return start;
+}
+
+void cpu_model_060::start_stream()
+{
+    n_ = stream_window;
+    reset(0);
+    end_ = 0;
+    streaming_ = true;
+}
+
+void cpu_model_060::stream_push(event_sink& sink)
+{
+    const size_t slot = end_ % stream_window;
+    if (slot < decoded_.classi.size())
+        decoded_.set(slot, decode(instructions_[slot]));
+    else
+        decoded_.push_back(decode(instructions_[slot]));
+    ++end_;
+    // A dispatch group can pair with the instruction after it, so only simulate it
+    // once that is known. This also frees the slot for the next push.
+    while (end_ - pos_ >= stream_window)
+        step(sink);
+}
+
+int cpu_model_060::finish_stream(event_sink& sink)
+{
+    while (!done())
+        step(sink);
+    sink.on(end_event { 0, cycle_ - 1, {} });
+    return cycle_ - 1;
+}
+
+void cpu_model_060::reset(int unroll)
 {
     cycle_ = 1;
     pos_ = 0;
     unroll_ = unroll;
-    for (auto& c : last_register_change_)
-        c.inst = nullptr;
+    end_ = (unroll + 1) * n_;
+    // Assume the loop was prefetched while the code before it executed
+    fetch_buffer_ = opts_.instruction_buffer_bytes;
+    streaming_ = false;
+    branch_cache_.assign(opts_.branch_cache_entries, { no_branch, 0 });
+    const size_t lines = opts_.data_cache_bytes / data_cache_line_bytes;
+    data_cache_ways_ = std::max<size_t>(1, std::min<size_t>(opts_.data_cache_ways, lines));
+    data_cache_.assign(lines / data_cache_ways_ * data_cache_ways_, no_line);
+    for (uint32_t r = 0; r < 8; ++r)
+        areg_address_[r] = { r + 1, 0 };
+    next_region_ = 9;
+    changed_regs_ = 0;
+}
 
-    constexpr size_t print_width = 40;
-    while (!done()) {
-        const auto& poep_ins = get();
-        int stall_cycles = 0;
-        if (auto stall = check_change_use(poep_ins); stall.cycles) {
-            if (print)
-                os_ << "\t; pOEP Change/use stall for " << stall.cycles << " cycles waiting for " << stall.reg << "\n";
-            stall_cycles += stall.cycles;
+// Everything that influences how the rest of the instruction stream is simulated,
+// relative to the current cycle
+std::vector<int> cpu_model_060::state_key() const
+{
+    std::vector<int> key;
+    key.push_back(static_cast<int>(pos_ % instructions_.size()));
+    key.push_back(fetch_buffer_);
+    for (const auto b : branches_) {
+        if (!branch_cache_.empty()) {
+            const auto& e = branch_cache_[b % branch_cache_.size()];
+            key.push_back(e.address == b ? e.state : -1);
         }
-
-        // TODO: The instruction isn't even fetched! https://eab.abime.net/showthread.php?t=111352&page=2
-        if (is_branch(poep_ins.op())) {
-            if (print) {
-                os_ << "\t; Assuming correctly predicated (taking 0 cycles)\n";
-                os_ << "\t" << with_width(poep_ins, print_width) << "\n";
-            }
-            continue;
+        if (const int length = decoded_.branch[b].length)
+            key.push_back(static_cast<int>(pos_ / instructions_.size() % length));
+    }
+    for (int r = 0; r < 16; ++r) {
+        // A register changed 3 or more cycles ago can no longer cause a stall
+        constexpr int max_age = 4;
+        const auto& rc = last_register_change_[r];
+        if (!(changed_regs_ & (1U << r)) || rc.kind == change_kind::agu)
+            key.push_back(max_age);
+        else
+            key.push_back(std::min(cycle_ - rc.cycle, max_age) + (rc.kind == change_kind::early ? max_age + 1 : 0));
+    }
+    if (!data_cache_.empty()) {
+        // Loops streaming through memory never repeat, the addresses keep advancing
+        for (const auto& a : areg_address_) {
+            key.push_back(static_cast<int>(a.region));
+            key.push_back(static_cast<int>(a.offset));
+        }
+        for (const auto line : data_cache_) {
+            key.push_back(static_cast<int>(line >> 32));
+            key.push_back(static_cast<int>(line));
         }
+    }
+    return key;
+}
 
-        // TODO: Instruction is available
-        // TODO: 10.1.1 Dispatch Test 1: sOEP Opword and Required Extension Words Are Valid
-        auto soep_ins = peek();
-        std::string reason;
-        if (soep_ins) {
-            reason = soep_ok(poep_ins, *soep_ins);
-            if (reason.empty()) {
-                // Change/use for address operations
-                // Seems to better match actual behavior having this here rather than in soep_ok
-                if (auto stall = check_change_use(*soep_ins); stall.cycles) {
-                    if (print)
-                        os_ << "\t; sOEP Change/use stall for " << stall.cycles << " cycles waiting for " << stall.reg << "\n";
-                    assert(stall_cycles == 0); // Only one of the 2 OEP's can be stalling
-                    stall_cycles += stall.cycles;
-                }
+template<typename Sink>
+void cpu_model_060::step(Sink& sink)
+{
+    const auto poep_pos = pos_;
+    const auto poep_idx = get();
+    const auto& poep_ins = instructions_[poep_idx];
+    const int poep_bytes = decoded_.bytes[poep_idx];
+    int stall_cycles = 0;
+    if (auto stall = check_change_use(poep_idx); stall.cycles) {
+        sink.on(stall_event { poep_pos, oep::poep, stall.reg, stall.cycles, stall.producer });
+        stall_cycles += stall.cycles;
+    }
+
+    if (decoded_.is_branch[poep_idx]) {
+        branch(poep_pos, poep_idx, poep_ins, sink);
+        return;
+    }
+
+    const auto soep_idx = peek();
+    soep_check check {};
+    if (soep_idx >= 0) {
+        check = soep_ok(poep_idx, soep_idx);
+        if (check.reason == soep_reason::none) {
+            // Change/use for address operations
+            // Seems to better match actual behavior having this here rather than in soep_ok
+            const auto stall = check_change_use(soep_idx);
+            // 10.1.1 Dispatch Test 1: sOEP Opword and Required Extension Words Are Valid
+            // (when the group can be dispatched)
+            if (buffered_after(fetch_ready(poep_bytes, std::max(stall_cycles, stall.cycles))) < poep_bytes + decoded_.bytes[soep_idx]) {
+                check = { soep_reason::fetch };
+            } else if (stall.cycles > stall_cycles) {
+                // If both OEPs are stalling the group waits for the longer one
+                sink.on(stall_event { pos_, oep::soep, stall.reg, stall.cycles - stall_cycles, stall.producer });
+                stall_cycles = stall.cycles;
             }
         }
+    }
 
-        const int icycles = poep_ins.cylces();
-        const int tcycles = icycles + stall_cycles;
-        assert(icycles > 0);
-        if (print) {
-            os_ << "\t; Cycle " << cycle_;
-            if (tcycles > 1)
-                os_ << "-" << (cycle_ + tcycles - 1);
-            os_ << "\n\t" << with_width(poep_ins, print_width) << "; pOEP\n";
-        }
+    // Instruction fetch continues during change/use stalls
+    if (const int ready = fetch_ready(poep_bytes, stall_cycles); ready > stall_cycles) {
+        sink.on(fetch_stall_event { poep_pos, ready - stall_cycles, buffered_after(stall_cycles) });
+        stall_cycles = ready;
+    }
 
-        cycle_ += stall_cycles;
-
-        update_register_change(poep_ins);
-
-        // TODO: Multicycle instruction with pOEP-until-last
-        if (soep_ins) {
-            if (reason.empty()) {
-                assert(soep_ins->cylces() == 1);
-                if (print)
-                    os_ << "\t" << with_width(*soep_ins, print_width) << "; sOEP\n";
-                ++pos_;
-                update_register_change(*soep_ins);
-            } else {
-                if (print)
-                    os_ << "\t; sOEP idle because " << reason << "\n"; 
+    // The operands are read once the instructions have been fetched (at most one of them accesses memory when paired)
+    if (!data_cache_.empty()) {
+        int misses = 0;
+        if (const int cycles = access_data(poep_idx, misses)) {
+            sink.on(data_cache_miss_event { poep_pos, oep::poep, misses, cycles });
+            stall_cycles += cycles;
+        }
+        if (soep_idx >= 0 && check.reason == soep_reason::none) {
+            misses = 0;
+            if (const int cycles = access_data(soep_idx, misses)) {
+                sink.on(data_cache_miss_event { pos_, oep::soep, misses, cycles });
+                stall_cycles += cycles;
             }
         }
-        cycle_ += icycles;
     }
-    if (print) {
-        os_ << "\n\n";
-        os_ << (cycle_ - 1) << " cycles";
-        if (unroll > 0)
-            os_ << " " << (static_cast<double>(cycle_ - 1) / (unroll + 1)) << " per iteration";
-        os_ << "\n";
+    fetch_buffer_ = buffered_after(stall_cycles) - poep_bytes;
+
+    const int icycles = decoded_.cycles[poep_idx];
+    assert(icycles > 0);
+    sink.on(dispatch_event { poep_pos, poep_ins, oep::poep, cycle_, icycles + stall_cycles, stall_cycles });
+
+    cycle_ += stall_cycles;
+
+    // The result is written in the last cycle, which is also when a pOEP-until-last
+    // instruction lets the sOEP instruction execute. (An)+/-(An) are updated in the first.
+    const int last_cycle = cycle_ + icycles - 1;
+    update_register_change(poep_idx, cycle_, last_cycle);
+
+    if (soep_idx >= 0) {
+        if (check.reason == soep_reason::none) {
+            const int soep_cycle = decoded_.classi[poep_idx] == oep_class::poep_until_last ? last_cycle : cycle_;
+            sink.on(dispatch_event { pos_, instructions_[soep_idx], oep::soep, soep_cycle, 1, 0 });
+            ++pos_;
+            fetch_buffer_ -= decoded_.bytes[soep_idx];
+            update_register_change(soep_idx, soep_cycle, soep_cycle);
+        } else {
+            sink.on(soep_idle_event { poep_pos, poep_ins, instructions_[soep_idx], check });
+        }
     }
-    return static_cast<double>(cycle_ - 1) / (unroll + 1);
+    fetch_buffer_ = buffered_after(icycles);
+    cycle_ += icycles;
+    sink.on(cycle_event { cycle_ });
 }
 
-void cpu_model_060::update_register_change(const instruction& i)
+template<typename Sink>
+void cpu_model_060::branch(size_t pos, size_t idx, const instruction& inst, Sink& sink)
 {
-    // TODO: (An)+/-(An) can also incur a penalty
-    auto r = i.execution_result_reg();
-    if (!r)
+    const size_t address = streaming_ ? pos : idx;
+    const bool taken = decoded_.branch[idx].is_taken(streaming_ ? 0 : pos / n_);
+    branch_cache_entry* entry = branch_cache_.empty() ? nullptr : &branch_cache_[address % branch_cache_.size()];
+    const bool hit = entry && entry->address == address;
+    // Branches that miss in the branch cache are predicted not taken, taken ones are allocated
+    const bool predicted_taken = hit && entry->state >= 2;
+    if (hit)
+        entry->state = static_cast<uint8_t>(taken ? std::min(entry->state + 1, 3) : std::max(entry->state - 1, 0));
+    else if (entry && taken)
+        *entry = { address, 3 };
+
+    if (taken && predicted_taken) {
+        // Folded: The branch cache redirects the fetch, so the branch itself isn't even fetched
+        sink.on(branch_event { pos, inst, cycle_, 0, taken, predicted_taken, hit });
         return;
-    assert(static_cast<int>(*r) < 16);
-    auto& rc = last_register_change_[static_cast<int>(*r)];
-    rc.cycle = cycle_;
-    rc.inst = &i;
+    }
+
+    if (taken == predicted_taken) {
+        // Correctly predicted not taken, executes in the pOEP
+        const int bytes = decoded_.bytes[idx];
+        if (const int ready = fetch_ready(bytes, 0); ready) {
+            sink.on(fetch_stall_event { pos, ready, buffered_after(0) });
+            fetch_buffer_ = buffered_after(ready);
+            cycle_ += ready;
+        }
+        fetch_buffer_ -= bytes;
+        sink.on(branch_event { pos, inst, cycle_, branch_not_taken_cycles, taken, predicted_taken, hit });
+        fetch_buffer_ = buffered_after(branch_not_taken_cycles);
+        cycle_ += branch_not_taken_cycles;
+    } else {
+        // Mispredicted: The pipeline is flushed and fetching restarts at the right address
+        sink.on(branch_event { pos, inst, cycle_, branch_mispredict_cycles, taken, predicted_taken, hit });
+        fetch_buffer_ = 0;
+        fetch_buffer_ = buffered_after(branch_mispredict_cycles);
+        cycle_ += branch_mispredict_cycles;
+    }
+    sink.on(cycle_event { cycle_ });
 }
 
-#define REASON(...) do { std::ostringstream oss; oss << __VA_ARGS__; return oss.str(); } while (0)
+// agu_cycle: When (An)+/-(An) are updated, result_cycle: When the result is written
+void cpu_model_060::update_register_change(size_t i, int agu_cycle, int result_cycle)
+{
+    for (uint32_t m = decoded_.agu_def[i]; m; m &= m - 1) {
+        int r = 0;
+        while (!(m & (1U << r)))
+            ++r;
+        last_register_change_[r] = { agu_cycle, pos_ - 1, change_kind::agu };
+        changed_regs_ |= 1U << r;
+    }
+    const int r = decoded_.result_reg[i];
+    if (r < 0)
+        return;
+    assert(r < 16);
+    last_register_change_[r] = { result_cycle, pos_ - 1, decoded_.early_result[i] ? change_kind::early : change_kind::result };
+    changed_regs_ |= 1U << r;
+}
 
-std::string cpu_model_060::soep_ok(const instruction& p, const instruction& s) const
+soep_check cpu_model_060::soep_ok(size_t p, size_t s) const
 {
     // 10.1.2 Dispatch Test 2: Instruction Classification
-    if (s.oep_classify() != oep_class::poep_or_soep)
-        REASON(s.op() << " is " << s.oep_classify());
-    if (p.oep_classify() == oep_class::poep_only)
-        REASON(p.op() << " is " << p.oep_classify());
+    if (decoded_.classi[s] != oep_class::poep_or_soep)
+        return { soep_reason::soep_class };
+    if (decoded_.classi[p] == oep_class::poep_only)
+        return { soep_reason::poep_class };
+    if (decoded_.cycles[s] > 1)
+        return { soep_reason::soep_cycles };
 
     // 10.1.3 Dispatch Test 3: Allowable Effective Addressing Mode in the sOEP
-    for (int i = 0; i < num_ea(s.op()); ++i) {
-        const auto& e = s.arg(i);
-        if (!soep_ea_ok(e))
-            REASON(e << " is not an allowable EA");
-    }
+    if (decoded_.bad_soep_ea[s] >= 0)
+        return { soep_reason::soep_ea, decoded_.bad_soep_ea[s] };
+
     // 10.1.4 Dispatch Test 4: Allowable Operand Data Memory Reference
-    if (p.mem_cycles() && s.mem_cycles())
-        REASON(s.op() << " also uses memory cycle");
-    if (s.mem_cycles() > 1)
-        REASON(s.op() << " uses more than one memory cycle");
+    if (decoded_.mem_cycles[p] && decoded_.mem_cycles[s])
+        return { soep_reason::both_mem };
+    if (decoded_.mem_cycles[s] > 1)
+        return { soep_reason::multi_mem };
 
-    auto p_result = p.execution_result_reg();
     //10.1.5 Dispatch Test 5: No Register Conflicts on sOEP.AGU Resources
     //10.1.6 Dispatch Test 6: No Register Conflicts on sOEP.IEE Resources
-    if (p_result) {
-        auto r = s.need_reg(*p_result);
-        if (r) {
-            // move.l ...,Rx can be forwarded to sOEP.A/B
-            // moveq isn't documented but can as well, also seems like clr.l can, maybe also lea
-            const bool is_movel = (p.op() == opcode::move && p.opsize() == 'l') || p.op() == opcode::moveq;
-            if (*r != resource::a_b || !is_movel)
-                REASON(s << " needs " << *p_result);
-        }
+    if (const uint32_t def = decoded_.def[p]; (def & (decoded_.use_base[s] | decoded_.use_index[s])) || ((def & decoded_.use_ab[s]) && !decoded_.forwards_ab[p]))
+        return { soep_reason::reg_conflict, -1, static_cast<eareg>(decoded_.result_reg[p]) };
+    // An updated by (An)+/-(An) in the pOEP isn't available to the sOEP in the same cycle
+    if (uint32_t m = decoded_.agu_def[p] & (decoded_.use_base[s] | decoded_.use_index[s] | decoded_.use_ab[s])) {
+        int r = 0;
+        while (!(m & (1U << r)))
+            ++r;
+        return { soep_reason::reg_conflict, -1, static_cast<eareg>(r) };
     }
     return {};
 }
-#undef REASON
 
-cpu_model_060::change_use_stall cpu_model_060::check_change_use(const instruction& i) const
+// Line fill cycles for the operands of instruction i, advances the address registers
+int cpu_model_060::access_data(size_t i, int& misses)
 {
-    const int nea = num_ea(i.op());
-    if (nea == 0)
-        return {};
-    if (auto stall = check_change_use(i.arg(0)); stall.cycles)
-        return stall;
-    if (nea == 1)
-        return {};
-    return check_change_use(i.arg(1));
+    const auto& d = decoded_.data[i];
+    int cycles = 0;
+    for (int n = 0; n < d.count; ++n) {
+        const auto& r = d.ref[n];
+        if (r.areg == data_ref::untracked)
+            continue;
+        data_address a { 0, static_cast<uint32_t>(r.disp) };
+        if (r.areg != data_ref::absolute) {
+            auto& base = areg_address_[r.areg];
+            base.offset += r.pre;
+            a = { base.region, base.offset + static_cast<uint32_t>(r.disp) };
+            base.offset += r.post;
+        }
+        const uint64_t first = (static_cast<uint64_t>(a.region) << 32 | a.offset) / data_cache_line_bytes;
+        const uint64_t last = ((static_cast<uint64_t>(a.region) << 32 | a.offset) + r.size - 1) / data_cache_line_bytes;
+        for (uint64_t line = first; line <= last; ++line) {
+            if (!data_cache_hit(line, r.store)) {
+                ++misses;
+                cycles += opts_.line_fill_cycles;
+            }
+        }
+    }
+
+    if (const int r = decoded_.result_reg[i]; r >= 8) {
+        auto& a = areg_address_[r - 8];
+        switch (d.update) {
+        case areg_update::fresh:
+            a = { next_region_++, 0 };
+            break;
+        case areg_update::add:
+            a.offset += static_cast<uint32_t>(d.value);
+            break;
+        case areg_update::copy:
+            a = areg_address_[d.src];
+            a.offset += static_cast<uint32_t>(d.value);
+            break;
+        case areg_update::absolute:
+            a = { 0, static_cast<uint32_t>(d.value) };
+            break;
+        }
+    }
+    return cycles;
 }
 
-cpu_model_060::change_use_stall cpu_model_060::check_change_use(const ea& e) const
+// Looks up (and allocates) a line, false if the access has to wait for a line fill
+bool cpu_model_060::data_cache_hit(uint64_t line, bool store)
 {
-    switch (e.val() >> ea_m_shift) {
-    case ea_m_Dn:
-    case ea_m_An:
-        return {};
-    case ea_m_A_ind:
-    case ea_m_A_ind_post:
-    case ea_m_A_ind_pre:
-    case ea_m_A_ind_disp16:
-        return calc_stall(static_cast<eareg>(8 + (e.val() & ea_xn_mask)), 2);
-    case ea_m_A_ind_index: {
-        const auto bew = get_brief_extension_word(e);
-        if (auto stall = calc_stall(bew.base, 2); stall.cycles)
-            return stall;
-        return calc_stall(bew.index, bew.long_size && (bew.scale == 1 || bew.scale == 4) ? 2 : 3);
+    const auto set = data_cache_.begin() + line % (data_cache_.size() / data_cache_ways_) * data_cache_ways_;
+    auto it = std::find(set, set + data_cache_ways_, line);
+    const bool hit = it != set + data_cache_ways_;
+    if (!hit) {
+        if (store && !opts_.write_allocate)
+            return true; // Goes to memory through the store buffer
+        it = set + data_cache_ways_ - 1; // Replace the least recently used line
     }
-    case ea_m_Other:
-        switch (e.val() & ea_xn_mask) {
-        case ea_other_abs_w:
-        case ea_other_abs_l:
-        case ea_other_pc_disp16:
-        case ea_other_imm:
-            return {};
-        //case ea_other_pc_index: // TODO
-        }
+    std::rotate(set, it, it + 1);
+    *set = line;
+    return hit;
+}
+
+cpu_model_060::change_use_stall cpu_model_060::check_change_use(size_t i) const
+{
+    // Registers used for address generation need to have been changed at least 2 (or 3) cycles ago
+    change_use_stall stall {};
+    for (uint32_t m = (decoded_.use_base[i] | decoded_.use_index[i]) & changed_regs_; m; m &= m - 1) {
+        int r = 0;
+        while (!(m & (1U << r)))
+            ++r;
+        const auto& rc = last_register_change_[r];
+        int need = decoded_.agu_slow[i] & (1U << r) ? 3 : 2;
+        if (rc.kind == change_kind::agu)
+            need = 0; // The AGU uses its own update
+        else if (rc.kind == change_kind::early && need == 2)
+            need = 1; // 10.2.3
+        const int cycles = need - (cycle_ - 1 - rc.cycle);
+        if (cycles > stall.cycles)
+            stall = { static_cast<eareg>(r), cycles, last_register_change_[r].pos };
     }
-    std::ostringstream oss;
-    oss << "TODO: implement check_change_use for " << e;
-    throw std::runtime_error(oss.str());
+    return stall;
+}
+
+incremental_model_060::incremental_model_060(const std::vector<instruction>& instructions)
+    : model_ { std::make_unique<cpu_model_060>(null_os_, instructions) }
+{
+}
+
+incremental_model_060::~incremental_model_060() = default;
+
+size_t incremental_model_060::update(size_t first_changed, event_sink& sink)
+{
+    return model_->resimulate(first_changed, sink);
+}
+
+stream_model_060::stream_model_060(event_sink& sink, const options_060& opts)
+    : sink_ { sink }
+    , model_ { std::make_unique<cpu_model_060>(null_os_, window_, opts) }
+{
+    window_.reserve(cpu_model_060::stream_window);
+    model_->start_stream();
+}
+
+stream_model_060::~stream_model_060() = default;
+
+void stream_model_060::push(const instruction& inst)
+{
+    const size_t slot = model_->stream_end() % cpu_model_060::stream_window;
+    if (slot < window_.size())
+        window_[slot] = inst;
+    else
+        window_.push_back(inst);
+    model_->stream_push(sink_);
+}
+
+int stream_model_060::finish()
+{
+    return model_->finish_stream(sink_);
 }
 
-cpu_model_060::change_use_stall cpu_model_060::calc_stall(const eareg& r, int cycles) const
+std::unique_ptr<event_sink> make_text_sink_060(std::ostream& os)
 {
-    // TODO: Check optimization in 10.2.3 [iff cycles == 2]
-    const int idx = static_cast<int>(r);
-    if (idx >= 16)
-        return {};
-    const auto& s = last_register_change_[idx];
-    if (!s.inst)
-        return {};
-    const int ago = cycle_ - 1 - s.cycle;
-    if (cycles <= ago)
-        return {};
-    return { r, cycles - ago };
+    return std::make_unique<text_sink>(os);
 }
 
-std::unique_ptr<cpu_model> make_cpu_model_060(std::ostream& os, const std::vector<instruction>& instructions)
+std::unique_ptr<cpu_model> make_cpu_model_060(std::ostream& os, instruction_view instructions, const options_060& opts)
 {
-    return std::make_unique<cpu_model_060>(os, instructions);
+    stat_timer timer { stat_phase::construct_060 };
+    timer.items(instructions.size());
+    return std::make_unique<cpu_model_060>(os, instructions, opts);
 }
\ No newline at end of file
@@ -2,12 +2,71 @@
 #define CPU_MODEL_060_H
 
 #include "cpu_model.h"
+#include "packed_instruction.h"
 #include <vector>
 #include <memory>
-#include <iosfwd>
+#include <ostream>
+class cpu_model_060;
 
-class instruction;
+// The instruction fetch unit fills the instruction buffer from the cache at a fixed rate
+// and an instruction can only be dispatched once all its words are in the buffer.
+//
+// The data cache is only modelled if data_cache_bytes is set (the 68060 has 8 KB). Addresses
+// are symbolic: each address register starts out pointing to its own (16 MB aligned) buffer,
+// and an instruction waits line_fill_cycles for each line its operands miss.
+struct options_060 {
+    int fetch_bytes_per_cycle = 4; // 0: Unlimited (fetch isn't modelled)
+    int instruction_buffer_bytes = 96; // At least max_instruction_bytes
+    int branch_cache_entries = 256;
+    int data_cache_bytes = 0; // 0: Every access hits (memory is only charged through mem_cycles)
+    int data_cache_ways = 4;
+    int line_fill_cycles = 20;
+    bool write_allocate = true; // Stores that miss fill the line (otherwise they just go to memory)
+};
 
-std::unique_ptr<cpu_model> make_cpu_model_060(std::ostream& os, const std::vector<instruction>& instructions);
+constexpr int max_instruction_bytes = 22;
+constexpr int data_cache_line_bytes = 16;
+
+std::unique_ptr<cpu_model> make_cpu_model_060(std::ostream& os, instruction_view instructions, const options_060& opts = {});
+
+// One pass (unroll 0) over instructions, which can be edited between calls to update.
+// The simulation state is saved at each dispatch group so an edit only re-simulates
+// from the last group before it.
+class incremental_model_060 {
+public:
+    explicit incremental_model_060(const std::vector<instruction>& instructions);
+    ~incremental_model_060();
+
+    // instructions changed from index first_changed onwards (use 0 for the first call).
+    // Events are only sent for the re-simulated part, the return value is the first
+    // instruction position it covers.
+    size_t update(size_t first_changed, event_sink& sink);
+
+private:
+    std::ostream null_os_ { nullptr };
+    std::unique_ptr<cpu_model_060> model_;
+};
+
+// Simulates a straight-line (non-looping) instruction stream of any length, e.g. read from
+// a pipe, in constant memory: only the next dispatch group is kept. The events for an
+// instruction are sent once the instruction after it has been pushed (or on finish).
+class stream_model_060 {
+public:
+    explicit stream_model_060(event_sink& sink, const options_060& opts = {});
+    ~stream_model_060();
+
+    void push(const instruction& inst);
+    // End of the stream, returns the total number of cycles
+    int finish();
+
+private:
+    std::ostream null_os_ { nullptr };
+    event_sink& sink_;
+    std::vector<instruction> window_; // The instruction at stream position pos is window_[pos % 2]
+    std::unique_ptr<cpu_model_060> model_;
+};
+
+// Prints the events in the same format as simulate(unroll, true)
+std::unique_ptr<event_sink> make_text_sink_060(std::ostream& os);
 
 #endif
@@ -80,13 +80,12 @@ int ea::num_words(bool is_long) const
 
 brief_extension_word get_brief_extension_word(const ea& e)
 {
-    // TODO: ea_other_pc_index
-    assert((e.val() >> ea_m_shift) == ea_m_A_ind_index);
+    assert((e.val() >> ea_m_shift) == ea_m_A_ind_index || e.val() == ea_pc_index);
 
     brief_extension_word bew {};
     const uint16_t extw = e.extra();
     bew.displacement = static_cast<int8_t>(extw & 255);
-    bew.base = static_cast<eareg>(8 + (e.val() & 7));
+    bew.base = e.val() == ea_pc_index ? eareg::pc : static_cast<eareg>(8 + (e.val() & 7));
     bew.index = static_cast<eareg>(extw >> 12);
     bew.long_size = !!(extw & (1 << 11));
     bew.scale = 1 << ((extw >> 9) & 3);
@@ -108,7 +107,8 @@ std::ostream& operator<<(std::ostream& os, const ea& e)
         return os << "-(a" << (e.val() & ea_xn_mask) << ")";
     case ea_m_A_ind_disp16:
         return os << static_cast<int16_t>(e.extra() & 0xffff) << "(a" << (e.val() & ea_xn_mask) << ")";
-    case ea_m_A_ind_index: {
+    case ea_m_A_ind_index:
+    index: {
         const auto bew = get_brief_extension_word(e);
         os << bew.displacement << '(' << bew.base << ',' << bew.index << '.' << (bew.long_size ? 'l' : 'w');
         if (bew.scale > 1)
@@ -123,7 +123,8 @@ std::ostream& operator<<(std::ostream& os, const ea& e)
             return os << "$" << std::hex << e.extra() << std::dec;
         case ea_other_pc_disp16:
             return os << static_cast<int16_t>(e.extra() & 0xffff) << "(pc)";
-        // case ea_other_pc_index:
+        case ea_other_pc_index:
+            goto index;
         case ea_other_imm:
             return os << "#" << static_cast<int>(e.extra());
         }
@@ -14,65 +14,112 @@ std::optional<eareg> reg_or_none(const ea& e)
     }
 }
 
-std::ostream& operator<<(std::ostream& os, opcode o)
+namespace {
+
+struct mnemonic {
+    std::string_view name;
+    opcode op;
+};
+
+constexpr mnemonic synonyms[] = {
+    { "adda", opcode::add },
+    { "cmpa", opcode::cmp },
+    { "movea", opcode::move },
+    { "dbf", opcode::dbra },
+};
+constexpr int num_synonyms = static_cast<int>(sizeof(synonyms) / sizeof(*synonyms));
+constexpr int num_mnemonics = num_opcodes + num_synonyms;
+
+constexpr mnemonic get_mnemonic(int i)
 {
-    // Special cases...
-    switch (o) {
-    case opcode::and_: return os << "and";
-    case opcode::or_: return os << "or";
-    }
-    switch (o) {
-#define X(o, rmw, nea, cycles, classi) case opcode::o: return os << #o;
-        OPCODES(X)
-#undef X
-    default:
-        return os << "opcode{" << static_cast<int>(o) << "}";
+    return i < num_opcodes ? mnemonic { opcode_infos[i].name, static_cast<opcode>(i) } : synonyms[i - num_opcodes];
+}
+
+constexpr uint32_t mnemonic_hash(std::string_view s, uint32_t seed)
+{
+    uint32_t h = 2166136261U ^ seed;
+    for (const char ch : s) {
+        h ^= static_cast<uint8_t>(ch);
+        h *= 16777619U;
     }
+    return h ^ (h >> 16);
 }
 
-opcode opcode_from_string(const std::string& str)
+constexpr int mnemonic_table_bits = 10;
+constexpr uint32_t mnemonic_table_mask = (1U << mnemonic_table_bits) - 1;
+static_assert(num_mnemonics < 255);
+
+struct mnemonic_table {
+    uint32_t seed;
+    uint8_t slot[1 << mnemonic_table_bits]; // index+1 into mnemonics (0 = empty)
+};
+
+// Find a seed for which all mnemonics hash to different slots
+constexpr mnemonic_table make_mnemonic_table()
 {
-#define X(o, rmw, nea, cycles, classi) if (str == #o) return opcode::o;
-    OPCODES(X)
-#undef X
-    // Synonyms/special cases
-    if (str == "adda") return opcode::add;
-    if (str == "and") return opcode::and_;
-    if (str == "or") return opcode::or_;
-    if (str == "not") return opcode::not_;
-    if (str == "cmpa") return opcode::cmp;
-    if (str == "movea") return opcode::move;
-    if (str == "dbf") return opcode::dbra;
-    throw std::runtime_error("Unknown opcode \"" + str + "\"");
+    for (uint32_t seed = 0; seed < 10000; ++seed) {
+        mnemonic_table t {};
+        t.seed = seed;
+        bool ok = true;
+        for (int i = 0; ok && i < num_mnemonics; ++i) {
+            auto& s = t.slot[mnemonic_hash(get_mnemonic(i).name, seed) & mnemonic_table_mask];
+            ok = !s;
+            s = static_cast<uint8_t>(i + 1);
+        }
+        if (ok)
+            return t;
+    }
+    return {};
 }
 
-bool is_rmw(opcode op)
+constexpr mnemonic_table mnemonics = make_mnemonic_table();
+
+constexpr bool valid_opcode_table()
 {
-    switch (op) {
-#define X(o, rmw, nea, cycles, classi) case opcode::o: return rmw;
-        OPCODES(X)
-#undef X
+    for (int i = 0; i < num_opcodes; ++i) {
+        const auto& info = opcode_infos[i];
+        if (info.name.empty() || info.nea < 0 || info.nea > 2 || info.cycles < 0)
+            return false;
+        if (info.rmw && !info.nea)
+            return false;
+        // Decided per instruction by instruction::oep_classify
+        if (info.classi == oep_class::poep_until_last)
+            return false;
     }
-    std::ostringstream oss;
-    oss << "TODO: Implement is_rmw " << op << "\n";
-    throw std::runtime_error { oss.str() };
+    for (int i = 0; i < num_mnemonics; ++i) {
+        for (int j = i + 1; j < num_mnemonics; ++j) {
+            if (get_mnemonic(i).name == get_mnemonic(j).name)
+                return false;
+        }
+    }
+    return true;
 }
 
-bool valid_size(char ch)
+static_assert(valid_opcode_table(), "Invalid entry in OPCODES");
+static_assert(mnemonics.slot[mnemonic_hash(get_mnemonic(0).name, mnemonics.seed) & mnemonic_table_mask], "No perfect hash found for mnemonics");
+
+} // unnamed namespace
+
+std::ostream& operator<<(std::ostream& os, opcode o)
 {
-    return !ch || ch == 's' || ch == 'b' || ch == 'w' || ch == 'l';
+    if (static_cast<int>(o) < 0 || static_cast<int>(o) >= num_opcodes)
+        return os << "opcode{" << static_cast<int>(o) << "}";
+    return os << get_opcode_info(o).name;
 }
 
-int num_ea(opcode op)
+opcode opcode_from_string(std::string_view str)
 {
-    switch (op) {
-#define X(o, rmw, nea, cycles, classi) case opcode::o: return nea;
-        OPCODES(X)
-#undef X
+    if (const int i = mnemonics.slot[mnemonic_hash(str, mnemonics.seed) & mnemonic_table_mask]) {
+        const auto m = get_mnemonic(i - 1);
+        if (m.name == str)
+            return m.op;
     }
-    std::ostringstream oss;
-    oss << "TODO: Implement num_ea " << op << "\n";
-    throw std::runtime_error { oss.str() };
+    throw std::runtime_error("Unknown opcode \"" + std::string { str } + "\"");
+}
+
+bool valid_size(char ch)
+{
+    return !ch || ch == 's' || ch == 'b' || ch == 'w' || ch == 'l';
 }
 
 bool is_branch(opcode op)
@@ -181,8 +228,9 @@ std::optional<resource> need_regX(const ea& e, eareg r)
     case ea_m_A_ind_disp16:
         if (!is_areg(r))
             return {};
-        return static_cast<int>(e.val() & 7) == static_cast<int>(r) ? std::optional(resource::base) : std::nullopt;
-    case ea_m_A_ind_index: {
+        return 8 + static_cast<int>(e.val() & ea_xn_mask) == static_cast<int>(r) ? std::optional(resource::base) : std::nullopt;
+    case ea_m_A_ind_index:
+    index: {
         const auto bew = get_brief_extension_word(e);
         if (r == bew.base)
             return resource::base;
@@ -196,7 +244,8 @@ std::optional<resource> need_regX(const ea& e, eareg r)
         case ea_other_abs_l:
         case ea_other_pc_disp16:
             return {};
-        // case ea_other_pc_index:
+        case ea_other_pc_index:
+            goto index;
         case ea_other_imm:
             return {};
         }
@@ -215,22 +264,18 @@ oep_class instruction::oep_classify() const
         return ea_[1].is_mem() && (ea_[0].is_mem() || ea_[0].val() == ea_immediate) ? oep_class::poep_until_last : oep_class::poep_or_soep;
     }
 
-    // TODO: Check if really standard instruction (i.e. only a single memory access)
-
-    switch (op_) {
-#define X(o, rmw, nea, cycles, classi) case opcode::o: return oep_class::classi;
-        OPCODES(X)
-#undef X
-    }
+    // Two memory operands (e.g. add.l (a0),(a1): two reads and a write) can't be a standard instruction
+    if (num_ea(op_) == 2 && ea_[0].is_mem() && ea_[1].is_mem())
+        return oep_class::poep_only;
 
-    std::ostringstream oss;
-    oss << "TODO: Implement OEP classificatoin for " << *this << "\n";
-    throw std::runtime_error { oss.str() };
+    return get_opcode_info(op_).classi;
 }
 
 int instruction::mem_cycles() const
 {
     // TODO: complex ea...
+    if (op_ == opcode::lea)
+        return 0; // Only calculates the address
     const bool rmw = is_rmw(op_);
     switch (num_ea(op_)) {
     case 0:
@@ -248,16 +293,7 @@ int instruction::mem_cycles() const
 
 int instruction::cylces() const
 {
-    int base = 0;
-    switch (op_) {
-#define X(o, rmw, nea, cycles, classi) case opcode::o: base = cycles; break;
-        OPCODES(X)
-#undef X
-    default:
-        std::ostringstream oss;
-        oss << "TODO: Implement cycles() for " << *this << "\n";
-        throw std::runtime_error { oss.str() };
-    }
+    int base = get_opcode_info(op_).cycles;
 
     if (op_ == opcode::divs || op_ == opcode::divu) {
         // TODO: Note 3 for divx.l (one extra cycle for some addressing modes)
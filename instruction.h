@@ -3,6 +3,7 @@
 
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <cassert>
 #include <optional>
 #include "ea.h"
@@ -38,6 +39,7 @@
     X(eor  ,true  ,2 ,1 ,poep_or_soep)  \
     X(ext  ,false ,1 ,1 ,poep_or_soep)  \
     X(extb ,false ,1 ,1 ,poep_or_soep)  \
+    X(lea  ,false ,2 ,1 ,poep_or_soep)  \
     X(lsl  ,true  ,2 ,1 ,poep_or_soep)  \
     X(lsr  ,true  ,2 ,1 ,poep_or_soep)  \
     X(move ,false ,2 ,1 ,poep_or_soep)  \
@@ -78,13 +80,6 @@ enum class opcode {
 #undef X
 };
 
-std::ostream& operator<<(std::ostream& os, opcode);
-opcode opcode_from_string(const std::string& str);
-int num_ea(opcode op);
-bool valid_size(char ch);
-bool is_branch(opcode op);
-bool is_shift_rot(opcode op);
-
 enum class oep_class {
     poep_or_soep,
     poep_only,
@@ -93,11 +88,66 @@ enum class oep_class {
 };
 std::ostream& operator<<(std::ostream& os, oep_class);
 
+struct opcode_info {
+    std::string_view name;
+    bool rmw;
+    int nea;
+    int cycles;
+    oep_class classi;
+};
+
+// Strip trailing underscore used to avoid clashing with keywords (and_ -> and)
+constexpr std::string_view opcode_name(std::string_view n)
+{
+    return n.back() == '_' ? n.substr(0, n.size() - 1) : n;
+}
+
+inline constexpr opcode_info opcode_infos[] = {
+#define X(o, rmw, nea, cycles, classi) { opcode_name(#o), rmw, nea, cycles, oep_class::classi },
+    OPCODES(X)
+#undef X
+};
+constexpr int num_opcodes = static_cast<int>(sizeof(opcode_infos) / sizeof(*opcode_infos));
+
+constexpr const opcode_info& get_opcode_info(opcode op)
+{
+    assert(static_cast<int>(op) >= 0 && static_cast<int>(op) < num_opcodes);
+    return opcode_infos[static_cast<int>(op)];
+}
+
+constexpr int num_ea(opcode op)
+{
+    return get_opcode_info(op).nea;
+}
+
+constexpr bool is_rmw(opcode op)
+{
+    return get_opcode_info(op).rmw;
+}
+
+std::ostream& operator<<(std::ostream& os, opcode);
+opcode opcode_from_string(std::string_view str);
+bool valid_size(char ch);
+bool is_branch(opcode op);
+bool is_shift_rot(opcode op);
+
 enum class resource {
     a_b, base, index
 };
 std::ostream& operator<<(std::ostream& os, resource);
 
+// Directions of a conditional branch in successive iterations (from a @branch annotation)
+struct branch_pattern {
+    uint32_t taken; // Bit n: Taken in iteration n, repeating every length iterations
+    uint8_t length; // 0 if not given (then assumed always taken)
+
+    bool is_taken(size_t iteration) const
+    {
+        return !length || (taken >> (iteration % length) & 1);
+    }
+};
+constexpr int max_branch_pattern = 32;
+
 class instruction {
 public:
     explicit instruction(opcode op, char sz)
@@ -152,10 +202,22 @@ public:
 
     int num_words() const;
 
+    const branch_pattern& branch() const
+    {
+        return branch_;
+    }
+
+    void set_branch(const branch_pattern& b)
+    {
+        assert(is_branch(op_) && op_ != opcode::bra);
+        branch_ = b;
+    }
+
 private:
     opcode op_;
     char size_;
     ea ea_[2];
+    branch_pattern branch_ {};
 };
 std::ostream& operator<<(std::ostream& os, const instruction&);
 bool has_embeeded_immediate(const instruction& ins); // If the immediate is embedded in the instruction
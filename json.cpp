@@ -0,0 +1,401 @@
+#include "json.h"
+#include "util.h"
+#include <ostream>
+#include <stdexcept>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+
+namespace {
+
+class json_reader {
+public:
+    explicit json_reader(std::string_view text)
+        : text_ { text }
+    {
+    }
+
+    json read_document()
+    {
+        auto j = read_value();
+        skip_ws();
+        if (pos_ != text_.size())
+            error("Unexpected data after value");
+        return j;
+    }
+
+private:
+    std::string_view text_;
+    size_t pos_ = 0;
+
+    [[noreturn]] void error(const std::string& msg) const
+    {
+        throw std::runtime_error { "JSON error: " + msg + " at position " + std::to_string(pos_) };
+    }
+
+    void skip_ws()
+    {
+        while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\r' || text_[pos_] == '\n'))
+            ++pos_;
+    }
+
+    char peek()
+    {
+        skip_ws();
+        return pos_ < text_.size() ? text_[pos_] : '\0';
+    }
+
+    void expect(char ch)
+    {
+        if (peek() != ch)
+            error(std::string { "Expected '" } + ch + "'");
+        ++pos_;
+    }
+
+    void expect_word(std::string_view word)
+    {
+        if (text_.substr(pos_, word.size()) != word)
+            error("Invalid literal");
+        pos_ += word.size();
+    }
+
+    json read_value()
+    {
+        switch (peek()) {
+        case '{': {
+            ++pos_;
+            auto j = json::object();
+            if (peek() == '}') {
+                ++pos_;
+                return j;
+            }
+            for (;;) {
+                if (peek() != '"')
+                    error("Expected member name");
+                auto key = read_string();
+                expect(':');
+                j[key] = read_value();
+                if (peek() == '}') {
+                    ++pos_;
+                    return j;
+                }
+                expect(',');
+            }
+        }
+        case '[': {
+            ++pos_;
+            auto j = json::array();
+            if (peek() == ']') {
+                ++pos_;
+                return j;
+            }
+            for (;;) {
+                j.push_back(read_value());
+                if (peek() == ']') {
+                    ++pos_;
+                    return j;
+                }
+                expect(',');
+            }
+        }
+        case '"':
+            return read_string();
+        case 't':
+            expect_word("true");
+            return true;
+        case 'f':
+            expect_word("false");
+            return false;
+        case 'n':
+            expect_word("null");
+            return nullptr;
+        case '\0':
+            error("Unexpected end of input");
+        }
+        return read_number();
+    }
+
+    json read_number()
+    {
+        const std::string s { text_.substr(pos_, 64) };
+        char* end;
+        const double n = std::strtod(s.c_str(), &end);
+        if (end == s.c_str())
+            error("Invalid value");
+        pos_ += end - s.c_str();
+        return n;
+    }
+
+    unsigned read_hex4()
+    {
+        if (pos_ + 4 > text_.size())
+            error("Invalid escape");
+        unsigned val = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char ch = text_[pos_++];
+            val <<= 4;
+            if (ch >= '0' && ch <= '9')
+                val |= ch - '0';
+            else if (ch >= 'a' && ch <= 'f')
+                val |= ch - 'a' + 10;
+            else if (ch >= 'A' && ch <= 'F')
+                val |= ch - 'A' + 10;
+            else
+                error("Invalid escape");
+        }
+        return val;
+    }
+
+    std::string read_string()
+    {
+        expect('"');
+        std::string res;
+        for (;;) {
+            if (pos_ >= text_.size())
+                error("Unterminated string");
+            const char ch = text_[pos_++];
+            if (ch == '"')
+                return res;
+            if (ch != '\\') {
+                res.push_back(ch);
+                continue;
+            }
+            if (pos_ >= text_.size())
+                error("Unterminated string");
+            switch (const char esc = text_[pos_++]) {
+            case '"':
+            case '\\':
+            case '/':
+                res.push_back(esc);
+                break;
+            case 'b':
+                res.push_back('\b');
+                break;
+            case 'f':
+                res.push_back('\f');
+                break;
+            case 'n':
+                res.push_back('\n');
+                break;
+            case 'r':
+                res.push_back('\r');
+                break;
+            case 't':
+                res.push_back('\t');
+                break;
+            case 'u': {
+                unsigned cp = read_hex4();
+                if (cp >= 0xd800 && cp < 0xdc00 && text_.substr(pos_, 2) == "\\u") {
+                    pos_ += 2;
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (read_hex4() - 0xdc00);
+                }
+                append_utf8(res, cp);
+                break;
+            }
+            default:
+                error("Invalid escape");
+            }
+        }
+    }
+
+    static void append_utf8(std::string& s, unsigned cp)
+    {
+        if (cp < 0x80) {
+            s.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            s.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        } else if (cp < 0x10000) {
+            s.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        } else {
+            s.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+    }
+};
+
+void dump_string(std::string& out, const std::string& s)
+{
+    out.push_back('"');
+    for (const char ch : s) {
+        switch (ch) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(ch) < 0x20)
+                out += "\\u" + hexstring(static_cast<uint16_t>(ch));
+            else
+                out.push_back(ch);
+        }
+    }
+    out.push_back('"');
+}
+
+void dump_number(std::string& out, double n)
+{
+    if (!std::isfinite(n)) {
+        out += "null";
+        return;
+    }
+    char buf[32];
+    if (n == std::floor(n) && std::fabs(n) < 1e15) {
+        snprintf(buf, sizeof(buf), "%.0f", n);
+    } else {
+        // Shortest form that reads back as the same value
+        for (int prec = 15; prec <= 17; ++prec) {
+            snprintf(buf, sizeof(buf), "%.*g", prec, n);
+            if (std::strtod(buf, nullptr) == n)
+                break;
+        }
+    }
+    out += buf;
+}
+
+} // unnamed namespace
+
+json json::parse(std::string_view text)
+{
+    return json_reader { text }.read_document();
+}
+
+bool json::as_bool() const
+{
+    if (type_ != type::boolean)
+        throw std::runtime_error { "JSON value is not a boolean" };
+    return bool_;
+}
+
+double json::as_number() const
+{
+    if (type_ != type::number)
+        throw std::runtime_error { "JSON value is not a number" };
+    return number_;
+}
+
+int json::as_int() const
+{
+    return static_cast<int>(as_number());
+}
+
+const std::string& json::as_string() const
+{
+    if (type_ != type::string)
+        throw std::runtime_error { "JSON value is not a string" };
+    return string_;
+}
+
+const std::vector<json>& json::as_array() const
+{
+    if (type_ != type::array)
+        throw std::runtime_error { "JSON value is not an array" };
+    return array_;
+}
+
+const std::vector<std::pair<std::string, json>>& json::as_object() const
+{
+    if (type_ != type::object)
+        throw std::runtime_error { "JSON value is not an object" };
+    return object_;
+}
+
+const json& json::operator[](std::string_view key) const
+{
+    static const json null_value;
+    if (type_ == type::object) {
+        for (const auto& [k, v] : object_) {
+            if (k == key)
+                return v;
+        }
+    }
+    return null_value;
+}
+
+json& json::operator[](std::string_view key)
+{
+    if (type_ == type::null)
+        type_ = type::object;
+    if (type_ != type::object)
+        throw std::runtime_error { "JSON value is not an object" };
+    for (auto& [k, v] : object_) {
+        if (k == key)
+            return v;
+    }
+    object_.emplace_back(std::string { key }, json {});
+    return object_.back().second;
+}
+
+void json::push_back(json value)
+{
+    if (type_ == type::null)
+        type_ = type::array;
+    if (type_ != type::array)
+        throw std::runtime_error { "JSON value is not an array" };
+    array_.push_back(std::move(value));
+}
+
+std::string json::dump() const
+{
+    std::string out;
+    dump(out);
+    return out;
+}
+
+void json::dump(std::string& out) const
+{
+    switch (type_) {
+    case type::null:
+        out += "null";
+        return;
+    case type::boolean:
+        out += bool_ ? "true" : "false";
+        return;
+    case type::number:
+        dump_number(out, number_);
+        return;
+    case type::string:
+        dump_string(out, string_);
+        return;
+    case type::array:
+        out.push_back('[');
+        for (size_t i = 0; i < array_.size(); ++i) {
+            if (i)
+                out.push_back(',');
+            array_[i].dump(out);
+        }
+        out.push_back(']');
+        return;
+    case type::object:
+        out.push_back('{');
+        for (size_t i = 0; i < object_.size(); ++i) {
+            if (i)
+                out.push_back(',');
+            dump_string(out, object_[i].first);
+            out.push_back(':');
+            object_[i].second.dump(out);
+        }
+        out.push_back('}');
+        return;
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, const json& j)
+{
+    return os << j.dump();
+}
@@ -0,0 +1,111 @@
+#ifndef JSON_H_INCLUDED
+#define JSON_H_INCLUDED
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <iosfwd>
+
+// Minimal JSON value, objects keep their keys in insertion order
+class json {
+public:
+    enum class type {
+        null,
+        boolean,
+        number,
+        string,
+        array,
+        object,
+    };
+
+    json() = default;
+    json(std::nullptr_t) {}
+    json(bool b)
+        : type_ { type::boolean }
+        , bool_ { b }
+    {
+    }
+    json(int n)
+        : json { static_cast<double>(n) }
+    {
+    }
+    json(size_t n)
+        : json { static_cast<double>(n) }
+    {
+    }
+    json(double n)
+        : type_ { type::number }
+        , number_ { n }
+    {
+    }
+    json(const char* s)
+        : json { std::string { s } }
+    {
+    }
+    json(std::string s)
+        : type_ { type::string }
+        , string_ { std::move(s) }
+    {
+    }
+
+    static json array()
+    {
+        json j;
+        j.type_ = type::array;
+        return j;
+    }
+
+    static json object()
+    {
+        json j;
+        j.type_ = type::object;
+        return j;
+    }
+
+    // Throws on syntax errors
+    static json parse(std::string_view text);
+
+    type kind() const
+    {
+        return type_;
+    }
+
+    bool is_null() const
+    {
+        return type_ == type::null;
+    }
+
+    // The accessors throw if the value has another type
+    bool as_bool() const;
+    double as_number() const;
+    int as_int() const;
+    const std::string& as_string() const;
+    const std::vector<json>& as_array() const;
+    const std::vector<std::pair<std::string, json>>& as_object() const;
+
+    // Member of an object (null if missing)
+    const json& operator[](std::string_view key) const;
+    // Member of an object, added if missing (a null value becomes an empty object)
+    json& operator[](std::string_view key);
+
+    // Append to an array (a null value becomes an empty array)
+    void push_back(json value);
+
+    // Compact text form
+    std::string dump() const;
+
+private:
+    type type_ = type::null;
+    bool bool_ = false;
+    double number_ = 0;
+    std::string string_;
+    std::vector<json> array_;
+    std::vector<std::pair<std::string, json>> object_;
+
+    void dump(std::string& out) const;
+};
+
+std::ostream& operator<<(std::ostream& os, const json& j);
+
+#endif
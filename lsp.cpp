@@ -0,0 +1,447 @@
+#include "lsp.h"
+#include "json.h"
+#include "parser.h"
+#include "cpu_model_060.h"
+#include "timeline.h"
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <algorithm>
+
+namespace {
+
+struct line_result {
+    std::optional<instruction> inst;
+    std::string error; // Empty if the line is ok
+    size_t error_column;
+};
+
+// Parses one line, also rejecting instructions the 68060 model can't handle yet
+line_result parse_line(const std::string& text, size_t line)
+{
+    line_result r {};
+    try {
+        parser p { text, line + 1 };
+        r.inst = p.next();
+        if (r.inst) {
+            std::ostream null_os { nullptr };
+            const std::vector<instruction> insts { *r.inst };
+            make_cpu_model_060(null_os, insts)->simulate(0, false);
+        }
+    } catch (const parse_error& e) {
+        r.inst.reset();
+        r.error = e.message();
+        r.error_column = e.column();
+    } catch (const std::exception& e) {
+        r.inst.reset();
+        r.error = e.what();
+    }
+    return r;
+}
+
+json make_position(size_t line, size_t character)
+{
+    json j;
+    j["line"] = line;
+    j["character"] = character;
+    return j;
+}
+
+json make_range(size_t line, size_t start, size_t end)
+{
+    json j;
+    j["start"] = make_position(line, start);
+    j["end"] = make_position(line, end);
+    return j;
+}
+
+enum severity {
+    severity_error = 1,
+    severity_warning = 2,
+    severity_information = 3,
+    severity_hint = 4,
+};
+
+class document {
+public:
+    explicit document(const std::string& text)
+        : model_ { insts_ }
+    {
+        set_text(text);
+    }
+
+    void set_text(const std::string& text)
+    {
+        lines_.clear();
+        parsed_.clear();
+        replace_lines(0, 0, text);
+        first_changed_line_ = 0;
+    }
+
+    // Replace the text between (start_line, start_char) and (end_line, end_char)
+    void edit(size_t start_line, size_t start_char, size_t end_line, size_t end_char, const std::string& text)
+    {
+        start_line = std::min(start_line, lines_.size() - 1);
+        end_line = std::min(end_line, lines_.size() - 1);
+        if (end_line < start_line)
+            end_line = start_line;
+        const auto& first = lines_[start_line];
+        const auto& last = lines_[end_line];
+        const auto new_text = first.substr(0, std::min(start_char, first.size())) + text + last.substr(std::min(end_char, last.size()));
+        replace_lines(start_line, end_line + 1, new_text);
+        first_changed_line_ = std::min(first_changed_line_, start_line);
+    }
+
+    // Bring the instructions and simulation results up to date with the edits so far
+    void update()
+    {
+        if (first_changed_line_ == no_change)
+            return;
+
+        // Instructions before the first changed line are unchanged (also in position)
+        const size_t first_changed = std::lower_bound(inst_lines_.begin(), inst_lines_.end(), first_changed_line_) - inst_lines_.begin();
+        insts_.erase(insts_.begin() + first_changed, insts_.end());
+        inst_lines_.resize(first_changed);
+        for (size_t l = first_changed_line_; l < parsed_.size(); ++l) {
+            if (parsed_[l].inst) {
+                insts_.push_back(*parsed_[l].inst);
+                inst_lines_.push_back(l);
+            }
+        }
+        first_changed_line_ = no_change;
+
+        simulation_error_.clear();
+        steady_.reset();
+        timeline_.instructions.resize(insts_.size());
+        try {
+            timeline_sink_060 sink { timeline_ };
+            model_.update(first_changed, sink);
+        } catch (const std::exception& e) {
+            simulation_error_ = e.what();
+        }
+    }
+
+    json diagnostics() const
+    {
+        auto res = json::array();
+        auto add = [&](size_t line, size_t start, severity s, const std::string& message) {
+            json d;
+            d["range"] = make_range(line, start, lines_[line].size());
+            d["severity"] = static_cast<int>(s);
+            d["source"] = "acycles";
+            d["message"] = message;
+            res.push_back(std::move(d));
+        };
+        for (size_t l = 0; l < parsed_.size(); ++l) {
+            if (!parsed_[l].error.empty())
+                add(l, parsed_[l].error_column, severity_error, parsed_[l].error);
+        }
+        if (!simulation_error_.empty()) {
+            add(0, 0, severity_error, simulation_error_);
+            return res;
+        }
+        for (size_t i = 0; i < insts_.size(); ++i) {
+            const auto& r = timeline_.instructions[i];
+            if (r.stall) {
+                std::ostringstream oss;
+                oss << r.pipe << " Change/use stall for " << r.stall << " cycles waiting for " << r.stall_reg;
+                add(inst_lines_[i], 0, severity_warning, oss.str());
+            }
+            if (r.soep_idle.reason != soep_reason::none) {
+                std::ostringstream oss;
+                oss << "sOEP idle because ";
+                print_reason(oss, r.soep_idle, insts_[i], insts_[i + 1]);
+                add(inst_lines_[i], 0, severity_hint, oss.str());
+            }
+        }
+        return res;
+    }
+
+    json inlay_hints(size_t first_line, size_t last_line) const
+    {
+        auto res = json::array();
+        if (!simulation_error_.empty())
+            return res;
+        auto add = [&](size_t line, const std::string& label) {
+            if (line < first_line || line > last_line)
+                return;
+            json h;
+            h["position"] = make_position(line, lines_[line].size());
+            h["label"] = label;
+            h["paddingLeft"] = true;
+            res.push_back(std::move(h));
+        };
+        for (size_t i = 0; i < insts_.size(); ++i) {
+            const auto& r = timeline_.instructions[i];
+            std::ostringstream oss;
+            if (r.branch) {
+                if (r.mispredicted)
+                    oss << "mispredicted branch";
+                else
+                    oss << (r.taken ? "folded branch" : "branch not taken");
+                if (r.cycles)
+                    oss << " cycle " << r.cycle << " (" << r.cycles << " cycles)";
+            } else {
+                oss << r.pipe << " cycle " << r.cycle;
+                if (r.cycles > 1)
+                    oss << "-" << r.cycle + r.cycles - 1;
+                if (r.stall)
+                    oss << " (+" << r.stall << " stall)";
+            }
+            add(inst_lines_[i], oss.str());
+        }
+        if (!inst_lines_.empty() && inst_lines_.back() >= first_line && inst_lines_.back() <= last_line) {
+            if (const auto* steady = steady_state_result()) {
+                std::ostringstream oss;
+                oss << steady->cycles_per_iteration() << " cycles/iteration";
+                if (!steady->exact)
+                    oss << " (approximate)";
+                add(inst_lines_.back(), oss.str());
+            }
+        }
+        return res;
+    }
+
+private:
+    static constexpr size_t no_change = ~size_t(0);
+    static constexpr size_t max_simulated = 100000; // Instructions simulated when looking for the steady state
+    std::vector<std::string> lines_;
+    std::vector<line_result> parsed_; // One per line
+    size_t first_changed_line_ = no_change;
+    std::vector<instruction> insts_;
+    std::vector<size_t> inst_lines_; // Line of each instruction
+    incremental_model_060 model_;
+    timeline_060 timeline_ {};
+    mutable std::optional<steady_state> steady_; // Only found when the hint is requested
+    std::string simulation_error_;
+
+    // The steady state isn't needed for every edit, so it's found on demand (nullptr if that fails)
+    const steady_state* steady_state_result() const
+    {
+        if (!steady_) {
+            try {
+                // Limit the work for long loops to keep up with typing
+                const int max_iterations = static_cast<int>(std::clamp<size_t>(max_simulated / (insts_.size() + 1), 2, 1000));
+                std::ostream null_os { nullptr };
+                steady_ = make_cpu_model_060(null_os, insts_)->find_steady_state(max_iterations);
+            } catch (const std::exception&) {
+                return nullptr;
+            }
+        }
+        return &*steady_;
+    }
+
+    // Replace lines [first, last) with text (which may contain newlines)
+    void replace_lines(size_t first, size_t last, const std::string& text)
+    {
+        std::vector<std::string> new_lines;
+        for (size_t pos = 0;;) {
+            const auto eol = text.find('\n', pos);
+            auto l = text.substr(pos, eol == std::string::npos ? std::string::npos : eol - pos);
+            if (!l.empty() && l.back() == '\r')
+                l.pop_back();
+            new_lines.push_back(std::move(l));
+            if (eol == std::string::npos)
+                break;
+            pos = eol + 1;
+        }
+        std::vector<line_result> new_parsed;
+        for (size_t i = 0; i < new_lines.size(); ++i)
+            new_parsed.push_back(parse_line(new_lines[i], first + i));
+        lines_.erase(lines_.begin() + first, lines_.begin() + last);
+        lines_.insert(lines_.begin() + first, new_lines.begin(), new_lines.end());
+        parsed_.erase(parsed_.begin() + first, parsed_.begin() + last);
+        parsed_.insert(parsed_.begin() + first, new_parsed.begin(), new_parsed.end());
+    }
+};
+
+class lsp_server {
+public:
+    explicit lsp_server(std::ostream& out)
+        : out_ { out }
+    {
+    }
+
+    // Returns false after the exit notification
+    bool handle(const json& msg)
+    {
+        const auto& method = msg["method"];
+        const auto& id = msg["id"];
+        if (method.is_null())
+            return true; // Response to a request we never sent
+        try {
+            const auto& m = method.as_string();
+            if (m == "exit")
+                return false;
+            auto result = dispatch(m, msg["params"]);
+            if (!id.is_null())
+                respond(id, std::move(result));
+        } catch (const std::exception& e) {
+            if (!id.is_null()) {
+                json err;
+                err["code"] = -32603;
+                err["message"] = e.what();
+                json r;
+                r["jsonrpc"] = "2.0";
+                r["id"] = id;
+                r["error"] = std::move(err);
+                send(r);
+            }
+        }
+        return true;
+    }
+
+    bool was_shutdown() const
+    {
+        return shutdown_;
+    }
+
+private:
+    std::ostream& out_;
+    std::map<std::string, std::unique_ptr<document>> documents_;
+    bool shutdown_ = false;
+    bool inlay_hint_refresh_ = false; // Client supports workspace/inlayHint/refresh
+    int next_request_id_ = 1;
+
+    json dispatch(const std::string& method, const json& params)
+    {
+        if (method == "initialize") {
+            const auto& refresh = params["capabilities"]["workspace"]["inlayHint"]["refreshSupport"];
+            inlay_hint_refresh_ = refresh.kind() == json::type::boolean && refresh.as_bool();
+            json res;
+            res["capabilities"]["textDocumentSync"]["openClose"] = true;
+            res["capabilities"]["textDocumentSync"]["change"] = 2; // Incremental
+            res["capabilities"]["inlayHintProvider"] = true;
+            res["serverInfo"]["name"] = "acycles";
+            return res;
+        } else if (method == "shutdown") {
+            shutdown_ = true;
+        } else if (method == "textDocument/didOpen") {
+            const auto& uri = params["textDocument"]["uri"].as_string();
+            auto& doc = documents_[uri];
+            doc = std::make_unique<document>(params["textDocument"]["text"].as_string());
+            publish(uri, *doc);
+        } else if (method == "textDocument/didChange") {
+            const auto& uri = params["textDocument"]["uri"].as_string();
+            auto& doc = get(uri);
+            for (const auto& c : params["contentChanges"].as_array()) {
+                const auto& range = c["range"];
+                if (range.is_null()) {
+                    doc.set_text(c["text"].as_string());
+                    continue;
+                }
+                const auto& start = range["start"];
+                const auto& end = range["end"];
+                doc.edit(start["line"].as_int(), start["character"].as_int(), end["line"].as_int(), end["character"].as_int(), c["text"].as_string());
+            }
+            publish(uri, doc);
+        } else if (method == "textDocument/didClose") {
+            const auto& uri = params["textDocument"]["uri"].as_string();
+            documents_.erase(uri);
+            notify_diagnostics(uri, json::array());
+        } else if (method == "textDocument/inlayHint") {
+            const auto& range = params["range"];
+            return get(params["textDocument"]["uri"].as_string()).inlay_hints(range["start"]["line"].as_int(), range["end"]["line"].as_int());
+        } else if (method.compare(0, 2, "$/") != 0 && method != "initialized" && method != "textDocument/didSave") {
+            throw std::runtime_error { "Unsupported method " + method };
+        }
+        return nullptr;
+    }
+
+    document& get(const std::string& uri)
+    {
+        auto it = documents_.find(uri);
+        if (it == documents_.end())
+            throw std::runtime_error { "Unknown document " + uri };
+        return *it->second;
+    }
+
+    void publish(const std::string& uri, document& doc)
+    {
+        doc.update();
+        notify_diagnostics(uri, doc.diagnostics());
+        if (!inlay_hint_refresh_)
+            return;
+        // Ask the client to fetch the changed hints
+        json req;
+        req["jsonrpc"] = "2.0";
+        req["id"] = "acycles-" + std::to_string(next_request_id_++);
+        req["method"] = "workspace/inlayHint/refresh";
+        send(req);
+    }
+
+    void notify_diagnostics(const std::string& uri, json diagnostics)
+    {
+        json n;
+        n["jsonrpc"] = "2.0";
+        n["method"] = "textDocument/publishDiagnostics";
+        n["params"]["uri"] = uri;
+        n["params"]["diagnostics"] = std::move(diagnostics);
+        send(n);
+    }
+
+    void respond(const json& id, json result)
+    {
+        json r;
+        r["jsonrpc"] = "2.0";
+        r["id"] = id;
+        r["result"] = std::move(result);
+        send(r);
+    }
+
+    void send(const json& msg)
+    {
+        const auto body = msg.dump();
+        out_ << "Content-Length: " << body.size() << "\r\n\r\n"
+             << body << std::flush;
+    }
+};
+
+// Next message body (empty at end of input)
+std::string read_message(std::istream& in)
+{
+    size_t length = 0;
+    bool have_length = false;
+    for (std::string line; std::getline(in, line);) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty()) {
+            if (!have_length)
+                continue;
+            std::string body(length, '\0');
+            if (!in.read(body.data(), length))
+                break;
+            return body;
+        }
+        constexpr std::string_view content_length = "Content-Length:";
+        if (line.compare(0, content_length.size(), content_length) == 0) {
+            length = std::stoul(line.substr(content_length.size()));
+            have_length = true;
+        }
+    }
+    return {};
+}
+
+} // unnamed namespace
+
+int serve_lsp(std::istream& in, std::ostream& out)
+{
+    lsp_server server { out };
+    for (;;) {
+        const auto body = read_message(in);
+        if (body.empty())
+            break;
+        json msg;
+        try {
+            msg = json::parse(body);
+        } catch (const std::exception&) {
+            continue;
+        }
+        if (!server.handle(msg))
+            break;
+    }
+    return server.was_shutdown() ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+#ifndef LSP_H_INCLUDED
+#define LSP_H_INCLUDED
+
+#include <iosfwd>
+
+// Language server (LSP over in/out) showing 68060 cycles, stalls and sOEP pairing
+// as inlay hints and diagnostics while editing.
+//
+// Documents are synced incrementally: an edit only re-parses the changed lines and
+// re-simulates from the last dispatch group before the first changed instruction.
+// Returns the exit code (0 if the client sent shutdown before exit).
+int serve_lsp(std::istream& in, std::ostream& out);
+
+#endif
@@ -1,54 +1,218 @@
 #include <iostream>
-#include <fstream>
 #include "parser.h"
+#include "mapped_file.h"
 #include "util.h"
-#include "cpu_model_020.h"
+#include "batch.h"
+#include "analysis.h"
+#include "result_cache.h"
+#include "server.h"
+#include "lsp.h"
+#include "json.h"
+#include "trace.h"
+#include "stats.h"
 #include "cpu_model_060.h"
+#include <sstream>
+#include <fstream>
+#include <memory>
+
+namespace {
+
+// parse_threads: Threads for parsing a large file (batch mode already runs files in parallel)
+void analyse_file(const std::string& filename, const analysis_options& opts, const result_cache* cache, unsigned parse_threads, std::ostream& os)
+{
+    const mapped_file source { filename };
+    const auto insts = parse_parallel(source.data(), parse_threads);
+    if (!cache) {
+        analyse(insts, opts, os);
+        return;
+    }
+
+    const auto key = result_key(insts, opts);
+    if (auto res = cache->get(key)) {
+        os << *res;
+        return;
+    }
+    std::ostringstream oss;
+    analyse(insts, opts, oss);
+    const auto res = oss.str();
+    cache->put(key, res);
+    os << res;
+}
+
+// Prints the 68060 timing of a straight-line instruction stream while it's being read
+void analyse_stream(std::istream& in, const options_060& opts, std::ostream& os)
+{
+    const auto sink = make_text_sink_060(os);
+    stream_model_060 model { *sink, opts };
+    parser p { in };
+    while (auto inst = p.next()) {
+        model.push(*inst);
+        // Don't hold back output while waiting for a slow producer
+        if (in.rdbuf()->in_avail() <= 0)
+            os.flush();
+    }
+    model.finish();
+}
+
+void print_batch(const std::vector<batch_result>& results, report_format format, std::ostream& os)
+{
+    int failed = 0;
+    for (const auto& r : results)
+        failed += !r.ok;
+
+    switch (format) {
+    case report_format::text:
+        for (const auto& r : results) {
+            os << "; " << r.filename << "\n";
+            if (r.ok)
+                os << r.output;
+            else
+                os << "Error: " << r.output << "\n";
+            os << "\n";
+        }
+        os << results.size() << " files, " << failed << " failed\n";
+        return;
+    case report_format::json:
+        // The reports are already json, so they're written as is
+        os << "{\"format\":\"acycles-batch\",\"version\":" << report_schema_version << ",\"files\":[";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            os << (i ? "," : "") << "{\"file\":" << json { r.filename };
+            if (r.ok) {
+                auto report = r.output;
+                while (!report.empty() && report.back() == '\n')
+                    report.pop_back();
+                os << ",\"report\":" << report;
+            } else {
+                os << ",\"error\":" << json { r.output };
+            }
+            os << "}";
+        }
+        os << "],\"failed\":" << failed << "}\n";
+        return;
+    case report_format::csv:
+        // Each report without its header, with the file name as the first column
+        os << "file," << csv_report_header << "\n";
+        for (const auto& r : results) {
+            const auto file = csv_field(r.filename);
+            if (!r.ok) {
+                os << file << "," << report_schema_version << ",,error,,," << csv_field(r.output) << ",,,,,,,,,,\n";
+                continue;
+            }
+            std::istringstream in { r.output };
+            std::string line;
+            std::getline(in, line);
+            while (std::getline(in, line))
+                os << file << "," << line << "\n";
+        }
+        return;
+    }
+}
+
+// Prints the stats (if enabled) when main returns
+struct stats_report {
+    ~stats_report()
+    {
+        if (active_tool_stats)
+            active_tool_stats->print(std::cerr);
+    }
+};
+
+} // unnamed namespace
 
 int main(int argc, char* argv[])
 {
+    tool_stats stats;
+    stats_report report;
     try {
-        int argp = 1;
-        int model = 68060;
-
-        if (argv[argp][0] == '-') {
-            model = atoi(argv[argp] + 1);
-            if (model < 68000)
-                model += 68000;
-            switch (model) {
-            case 68020:
-            case 68060:
-                break;
-            default:
-                throw std::runtime_error { std::string { "Unsupported CPU model " } + (argv[argp] + 1) };
+        analysis_options opts;
+        unsigned num_threads = 0;
+        std::unique_ptr<result_cache> cache;
+        std::vector<std::string> sources;
+        std::optional<std::string> server;
+        std::string trace_file;
+        bool stream = false;
+
+        for (int argp = 1; argp < argc; ++argp) {
+            const std::string arg { argv[argp] };
+            if (arg == "--lsp") {
+                return serve_lsp(std::cin, std::cout);
+            } else if (arg == "--stream") {
+                stream = true;
+            } else if (arg == "--server") {
+                server = "";
+            } else if (arg.compare(0, 9, "--server=") == 0) {
+                server = arg.substr(9);
+            } else if (arg == "--stats") {
+                active_tool_stats = &stats;
+            } else if (arg.compare(0, 8, "--trace=") == 0) {
+                trace_file = arg.substr(8);
+            } else if (arg.compare(0, 8, "--cache=") == 0) {
+                cache = std::make_unique<result_cache>(arg.substr(8));
+            } else if (arg.size() > 2 && arg[0] == '-' && arg[1] == 'j') {
+                num_threads = atoi(argv[argp] + 2);
+            } else if (parse_analysis_option(arg, opts)) {
+                continue;
+            } else if (arg.size() > 1 && arg[0] == '-') {
+                throw std::runtime_error { "Unknown option " + arg };
+            } else if (!arg.empty()) {
+                sources.push_back(arg);
             }
-            ++argp;
-        }
-        if (argp + 1 != argc || !argv[argp][0])
-            throw std::runtime_error { "Usage: " + std::string { argv[0] } + " [-68020/-68060] source" };
-
-        std::ifstream in { argv[argp] };
-        if (!in)
-            throw std::runtime_error {"Could not open " + std::string{argv[argp] } };
-        parser p { in };
-        const auto insts = p.all();
-        int instruction_words = 0;
-        for (const auto& i : insts) {
-            instruction_words += i.num_words();
-            //std::cout << "\t" << with_width(i,30) << "; length " << i.num_words() << " \n";
-        }
-
-        if (model == 68060) {
-            auto cpu = make_cpu_model_060(std::cout, insts);
-            cpu->simulate(1, true);
-            double res = cpu->simulate(100, false);
-            std::cout << "Instruction words in loop: " << instruction_words << ", " << res << " cycles/iteration"
-                      << "\n";
-        } else {
-            assert(model == 68020);
-            auto cpu = make_cpu_model_020(std::cout, insts);
-            cpu->simulate(0, true);
         }
+        if (server) {
+            analysis_server srv { opts, cache.get() };
+            if (server->empty())
+                srv.serve(std::cin, std::cout);
+            else
+                srv.listen(*server);
+            return 0;
+        }
+        if (stream) {
+            if (opts.model != 68060)
+                throw std::runtime_error { "--stream is only supported for the 68060" };
+            if (sources.size() > 1)
+                throw std::runtime_error { "--stream needs a single source (or none for standard input)" };
+            if (sources.empty()) {
+                std::ios::sync_with_stdio(false);
+                analyse_stream(std::cin, opts.cpu_060, std::cout);
+                return 0;
+            }
+            std::ifstream in { sources[0] };
+            if (!in)
+                throw std::runtime_error { "Could not open " + sources[0] };
+            analyse_stream(in, opts.cpu_060, std::cout);
+            return 0;
+        }
+
+        if (sources.empty())
+            throw std::runtime_error { "Usage: " + std::string { argv[0] } + " [-68020/-68060] [-jN] [--format=text/json/csv] [--unroll=N] [--fetch=bytes/cycle] [--ibuffer=bytes] [--dcache[=bytes]] [--dcache-ways=N] [--line-fill=cycles] [--no-write-allocate] [--profile] [--stats] [--cache=dir] source... (directories and wildcards select batch mode)\n"
+                                       "       " + std::string { argv[0] } + " [--cache=dir] --server[=socket]\n"
+                                       "       " + std::string { argv[0] } + " --lsp\n"
+                                       "       " + std::string { argv[0] } + " --stream [source]\n"
+                                       "       " + std::string { argv[0] } + " [--unroll=N] --trace=file.json source" };
+
+        if (sources.size() == 1 && !is_batch_source(sources[0])) {
+            if (!trace_file.empty()) {
+                std::ofstream out { trace_file };
+                if (!out)
+                    throw std::runtime_error { "Could not create " + trace_file };
+                const mapped_file source { sources[0] };
+                write_chrome_trace(parser { source.data() }.all(), opts.unroll, sources[0], out, opts.cpu_060);
+                return 0;
+            }
+            analyse_file(sources[0], opts, cache.get(), num_threads, std::cout);
+            return 0;
+        }
+        if (!trace_file.empty())
+            throw std::runtime_error { "--trace needs a single source file" };
+
+        const auto results = run_batch(expand_sources(sources), [&](const std::string& filename, std::ostream& os) { analyse_file(filename, opts, cache.get(), 1, os); }, num_threads);
+        print_batch(results, opts.format, std::cout);
+        for (const auto& r : results) {
+            if (!r.ok)
+                return 1;
+        }
+        return 0;
     } catch (const std::exception& e) {
         std::cerr << e.what() << "\n";
         return 1;
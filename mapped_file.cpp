@@ -0,0 +1,74 @@
+#include "mapped_file.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+mapped_file::mapped_file(const std::string& filename)
+{
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error { "Could not open " + filename };
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error { "Could not get size of " + filename };
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_) {
+        mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_)
+            data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    }
+    CloseHandle(file);
+    if (size_ && !data_) {
+        if (mapping_)
+            CloseHandle(mapping_);
+        throw std::runtime_error { "Could not map " + filename };
+    }
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_)
+        UnmapViewOfFile(data_);
+    if (mapping_)
+        CloseHandle(mapping_);
+}
+#else
+mapped_file::mapped_file(const std::string& filename)
+{
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error { "Could not open " + filename };
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw std::runtime_error { "Could not get size of " + filename };
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_) {
+        void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error { "Could not map " + filename };
+        }
+        madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+    }
+    close(fd);
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_)
+        munmap(const_cast<char*>(data_), size_);
+}
+#endif
@@ -0,0 +1,42 @@
+#include "packed_instruction.h"
+
+void instruction_arena::push_back(const instruction& i)
+{
+    packed_instruction p {};
+    p.op = static_cast<uint8_t>(i.op());
+    p.size = i.opsize();
+    p.extra = static_cast<uint32_t>(extras_.size());
+    for (int n = 0; n < num_ea(i.op()); ++n) {
+        const auto& e = i.arg(n);
+        p.ea_val[n] = e.val();
+        if (ea_has_extra(e.val())) {
+            p.ea_val[n] |= packed_has_extra;
+            extras_.push_back(e.extra());
+        }
+    }
+    if (const auto& b = i.branch(); b.length) {
+        p.ea_val[1] = packed_has_extra;
+        extras_.push_back(b.taken);
+        extras_.push_back(b.length);
+    }
+    insts_.push_back(p);
+}
+
+void instruction_arena::append(const instruction_arena& other)
+{
+    const auto offset = static_cast<uint32_t>(extras_.size());
+    for (auto p : other.insts_) {
+        p.extra += offset;
+        insts_.push_back(p);
+    }
+    extras_.insert(extras_.end(), other.extras_.begin(), other.extras_.end());
+}
+
+std::vector<instruction> instruction_arena::unpack() const
+{
+    std::vector<instruction> res;
+    res.reserve(size());
+    for (size_t i = 0; i < size(); ++i)
+        res.push_back((*this)[i]);
+    return res;
+}
@@ -0,0 +1,111 @@
+#ifndef PACKED_INSTRUCTION_H_INCLUDED
+#define PACKED_INSTRUCTION_H_INCLUDED
+
+#include <vector>
+#include <cstdint>
+#include "instruction.h"
+
+// 8 byte form of an instruction, the ea extension values are kept in the arena
+struct packed_instruction {
+    uint8_t op;
+    char size;
+    uint8_t ea_val[2]; // ea::val(), packed_has_extra set if it has an extension value
+    uint32_t extra; // Index of the first extension value in the arena (ea 0 before ea 1)
+    // Branches only have one ea, packed_has_extra in ea_val[1] means the branch pattern
+    // (taken, length) follows as two extension values
+};
+static_assert(sizeof(packed_instruction) == 8);
+constexpr uint8_t packed_has_extra = 0x80;
+static_assert(num_opcodes <= 256);
+
+// Packed instructions with their extension values, for very long inputs
+class instruction_arena {
+public:
+    void reserve(size_t instructions, size_t extension_values)
+    {
+        insts_.reserve(instructions);
+        extras_.reserve(extension_values);
+    }
+
+    size_t size() const
+    {
+        return insts_.size();
+    }
+
+    bool empty() const
+    {
+        return insts_.empty();
+    }
+
+    void push_back(const instruction& i);
+    void append(const instruction_arena& other);
+
+    instruction operator[](size_t i) const;
+
+    std::vector<instruction> unpack() const;
+
+private:
+    std::vector<packed_instruction> insts_;
+    std::vector<uint32_t> extras_;
+};
+
+inline instruction instruction_arena::operator[](size_t i) const
+{
+    const auto& p = insts_[i];
+    const auto op = static_cast<opcode>(p.op);
+    const uint32_t* extra = extras_.data() + p.extra;
+    auto get_ea = [&](int n) {
+        const uint8_t val = p.ea_val[n] & ~packed_has_extra;
+        if (!(p.ea_val[n] & packed_has_extra))
+            return ea { val };
+        return ea { val, *extra++ };
+    };
+    switch (num_ea(op)) {
+    case 0:
+        return instruction { op, p.size };
+    case 1: {
+        instruction i { op, p.size, get_ea(0) };
+        if (p.ea_val[1] & packed_has_extra)
+            i.set_branch({ extra[0], static_cast<uint8_t>(extra[1]) });
+        return i;
+    }
+    }
+    const auto ea0 = get_ea(0);
+    return instruction { op, p.size, ea0, get_ea(1) };
+}
+
+// Read-only access to the instructions of a loop, whether they're stored unpacked or packed.
+// Refers to the container (not its elements), so the container may change while the view is used.
+class instruction_view {
+public:
+    instruction_view(const std::vector<instruction>& insts)
+        : vec_ { &insts }
+    {
+    }
+
+    instruction_view(const instruction_arena& arena)
+        : arena_ { &arena }
+    {
+    }
+
+    size_t size() const
+    {
+        return vec_ ? vec_->size() : arena_->size();
+    }
+
+    bool empty() const
+    {
+        return !size();
+    }
+
+    instruction operator[](size_t i) const
+    {
+        return vec_ ? (*vec_)[i] : (*arena_)[i];
+    }
+
+private:
+    const std::vector<instruction>* vec_ = nullptr;
+    const instruction_arena* arena_ = nullptr;
+};
+
+#endif
@@ -1,41 +1,74 @@
 #include "parser.h"
+#include "stats.h"
+#include "batch.h"
 #include <sstream>
 #include <limits.h>
+#include <algorithm>
+#include <thread>
 
 char lower(char ch)
 {
     return ch >= 'A' && ch <= 'Z' ? ch | 0x20 : ch;
 }
 
-void remove_comments(std::string& line)
+void remove_comments(std::string_view& line)
 {
     if (line.empty())
         return;
     auto pos = line.find_first_of(";");
-    if (pos == std::string::npos)
+    if (pos == std::string_view::npos)
         pos = line.size();
     while (pos && isspace(line[pos - 1]))
         --pos;
-    line.erase(pos);
-
+    line = line.substr(0, pos);
 }
 
 #define PARSER_EXPECT_NOT_EOL() do { if (pos_ == line_.size()) error("Unexpected end of line in " + std::string(__func__) + " line " + std::to_string(__LINE__)); } while (0)
 #define PARSER_EXPECT(ch) do { if (pos_ == line_.size() || line_[pos_] != (ch)) error("Expected " + std::string(1, ch) + " in " + std::string(__func__) + " line " + std::to_string(__LINE__)); ++pos_; } while (0)
 
 parser::parser(std::istream& in)
-    : in_ { in }
+    : in_ { &in }
+{
+}
+
+parser::parser(std::string_view text, size_t first_line)
+    : text_ { text }
+    , line_num_ { first_line }
+{
+}
+
+bool parser::read_line()
 {
+    if (in_) {
+        if (!std::getline(*in_, buffer_))
+            return false;
+        line_ = buffer_;
+        return true;
+    }
+
+    // Same line splitting as std::getline
+    if (text_.empty())
+        return false;
+    const auto eol = text_.find('\n');
+    line_ = text_.substr(0, eol);
+    text_.remove_prefix(eol == std::string_view::npos ? text_.size() : eol + 1);
+    return true;
 }
 
 std::optional<instruction> parser::next()
 {
     for (;;) {
-        if (!std::getline(in_, line_))
+        if (!read_line())
             return {};
+        const auto branch = parse_branch_annotation();
         remove_comments(line_);
         pos_ = 0;
         auto res = do_parse();
+        if (branch) {
+            if (!res || !is_branch(res->op()) || res->op() == opcode::bra)
+                error("@branch needs a conditional branch");
+            res->set_branch(*branch);
+        }
         ++line_num_;
         if (res)
             return res;
@@ -44,12 +77,123 @@ std::optional<instruction> parser::next()
 
 std::vector<instruction> parser::all()
 {
+    stat_timer timer { stat_phase::parse };
     std::vector<instruction> res;
     while (auto i = next())
         res.emplace_back(std::move(*i));
+    timer.items(res.size());
+    return res;
+}
+
+instruction_arena parse_parallel(std::string_view text, unsigned num_threads, size_t min_chunk_size)
+{
+    // Split at line starts into about 4 chunks per thread
+    if (!num_threads)
+        num_threads = std::max(1U, std::thread::hardware_concurrency());
+    const size_t chunk_size = std::max(min_chunk_size, text.size() / (num_threads * 4) + 1);
+    if (num_threads == 1 || text.size() <= chunk_size)
+        return parser { text }.all_packed();
+    std::vector<std::string_view> chunks;
+    while (!text.empty()) {
+        size_t len = std::min(chunk_size, text.size());
+        if (len < text.size()) {
+            const auto eol = text.find('\n', len - 1);
+            len = eol == std::string_view::npos ? text.size() : eol + 1;
+        }
+        chunks.push_back(text.substr(0, len));
+        text.remove_prefix(len);
+    }
+
+    std::vector<size_t> first_line(chunks.size() + 1, 1);
+    parallel_for(chunks.size(), [&](size_t i) {
+        first_line[i + 1] = std::count(chunks[i].begin(), chunks[i].end(), '\n');
+    }, num_threads);
+    for (size_t i = 1; i < first_line.size(); ++i)
+        first_line[i] += first_line[i - 1];
+
+    std::vector<instruction_arena> parsed(chunks.size());
+    parallel_for(chunks.size(), [&](size_t i) {
+        parsed[i] = parser { chunks[i], first_line[i] }.all_packed();
+    }, num_threads);
+
+    instruction_arena res;
+    size_t total = 0;
+    for (const auto& p : parsed)
+        total += p.size();
+    res.reserve(total, total);
+    for (const auto& p : parsed)
+        res.append(p);
+    return res;
+}
+
+instruction_arena parser::all_packed()
+{
+    stat_timer timer { stat_phase::parse };
+    instruction_arena res;
+    if (!in_) {
+        const size_t lines = std::count(text_.begin(), text_.end(), '\n') + 1;
+        res.reserve(lines, lines);
+    }
+    while (auto i = next())
+        res.push_back(*i);
+    timer.items(res.size());
     return res;
 }
 
+// "@branch TTN" in the comment gives the direction in successive iterations (repeating),
+// "@branch 3/4" means taken 3 of every 4 iterations (spread evenly)
+std::optional<branch_pattern> parser::parse_branch_annotation()
+{
+    const auto comment = line_.find(';');
+    if (comment == std::string_view::npos)
+        return {};
+    const auto at = line_.find("@branch", comment);
+    if (at == std::string_view::npos)
+        return {};
+    pos_ = at + 7;
+    skip_space();
+    const size_t start = pos_;
+    while (pos_ < line_.size() && !isspace(line_[pos_]))
+        ++pos_;
+    const auto value = line_.substr(start, pos_ - start);
+    pos_ = start;
+
+    branch_pattern b {};
+    if (const auto slash = value.find('/'); slash != std::string_view::npos) {
+        auto number = [](std::string_view s) {
+            int n = 0;
+            for (const char ch : s) {
+                if (!isdigit(ch) || n > max_branch_pattern)
+                    return -1;
+                n = n * 10 + (ch - '0');
+            }
+            return s.empty() ? -1 : n;
+        };
+        const int taken = number(value.substr(0, slash));
+        const int total = number(value.substr(slash + 1));
+        if (taken < 0 || total < 1 || taken > total || total > max_branch_pattern)
+            error("Invalid @branch ratio (expected taken/total with total at most " + std::to_string(max_branch_pattern) + ")");
+        for (int n = 0; n < total; ++n) {
+            if ((n + 1) * taken / total > n * taken / total)
+                b.taken |= 1U << n;
+        }
+        b.length = static_cast<uint8_t>(total);
+        return b;
+    }
+
+    if (value.empty() || value.size() > max_branch_pattern)
+        error("Invalid @branch pattern (expected T/N for each iteration, at most " + std::to_string(max_branch_pattern) + ")");
+    for (size_t n = 0; n < value.size(); ++n) {
+        const char ch = lower(value[n]);
+        if (ch == 't')
+            b.taken |= 1U << n;
+        else if (ch != 'n')
+            error("Invalid @branch pattern (expected T/N for each iteration)");
+    }
+    b.length = static_cast<uint8_t>(value.size());
+    return b;
+}
+
 void parser::skip_space()
 {
     while (pos_ < line_.size() && isspace(line_[pos_]))
@@ -60,7 +204,7 @@ void parser::error(const std::string& msg)
 {
     std::ostringstream oss;
     oss << "Error in line " << line_num_ << ": " << msg << " at position " << pos_ << " in line \"" << line_ << "\"";
-    throw std::runtime_error { oss.str() };
+    throw parse_error { oss.str(), msg, line_num_, pos_ };
 }
 
 std::optional<eareg> parser::parse_reg()
@@ -161,7 +305,20 @@ ea parser::parse_ea()
     std::optional<uint32_t> dispval {};
     if (line_[pos_] != '(') {
         dispval = parse_number();
-        // TODO: ABS.w
+        bool abs_w = false;
+        if (pos_ + 1 < line_.size() && line_[pos_] == '.' && (lower(line_[pos_ + 1]) == 'w' || lower(line_[pos_ + 1]) == 'l')) {
+            abs_w = lower(line_[pos_ + 1]) == 'w';
+            pos_ += 2;
+            if (pos_ < line_.size() && line_[pos_] != ',')
+                error("Invalid absolute address");
+        }
+        if (abs_w) {
+            // Sign extended to 32 bits
+            int32_t a = *dispval;
+            if (a < SHRT_MIN || a > USHRT_MAX)
+                error("Absolute address out of range for .w");
+            return ea { static_cast<uint8_t>(ea_m_Other << ea_m_shift | ea_other_abs_w), static_cast<uint16_t>(a) };
+        }
         if (pos_ == line_.size() || line_[pos_] == ',')
             return ea { static_cast<uint8_t>(ea_m_Other << ea_m_shift | ea_other_abs_l), *dispval };
     }
@@ -230,7 +387,7 @@ ea parser::parse_ea()
             else if (scale == 4)
                 scale = 2;
             else if (scale == 8)
-                scale = 4;
+                scale = 3;
             else
                 error("Invalid scale");            
         }
@@ -242,7 +399,10 @@ ea parser::parse_ea()
                 error("Displacmeent out of range");
             disp = static_cast<uint8_t>(d & 0xff);
         }
-        return ea { static_cast<uint8_t>((static_cast<uint8_t>(*basereg) & ea_xn_mask) | ea_m_A_ind_index << ea_m_shift), static_cast<uint16_t>(static_cast<int>(*dispreg) << 12 | long_size << 11 | scale << 9 | disp) };
+        const uint16_t extw = static_cast<uint16_t>(static_cast<int>(*dispreg) << 12 | long_size << 11 | scale << 9 | disp);
+        if (*basereg == eareg::pc)
+            return ea { ea_pc_index, extw };
+        return ea { static_cast<uint8_t>((static_cast<uint8_t>(*basereg) & ea_xn_mask) | ea_m_A_ind_index << ea_m_shift), extw };
     }
 
     error("Unhandled EA in parse_ea");
@@ -253,11 +413,9 @@ std::optional<instruction> parser::do_parse()
     if (line_.empty())
         return {};
 
-    std::string label;
-
-    while (pos_ < line_.size() && !isspace(line_[pos_]) && line_[pos_] != ':') {
-        label.push_back(line_[pos_++]);
-    }
+    // Skip label
+    while (pos_ < line_.size() && !isspace(line_[pos_]) && line_[pos_] != ':')
+        ++pos_;
     if (pos_ && pos_ < line_.size() && line_[pos_] == ':')
         ++pos_;
 
@@ -266,12 +424,31 @@ std::optional<instruction> parser::do_parse()
     if (pos_ == line_.size())
         return {};
 
-    std::string ins_str;
+    char ins_buf[16];
+    size_t ins_len = 0;
     char suffix = 0;
-    while (pos_ < line_.size() && !isspace(line_[pos_]) && line_[pos_] != '.')
-        ins_str.push_back(lower(line_[pos_++]));
-
-    const auto opcode = opcode_from_string(ins_str);
+    const size_t ins_start = pos_;
+    while (pos_ < line_.size() && !isspace(line_[pos_]) && line_[pos_] != '.') {
+        if (ins_len < sizeof(ins_buf))
+            ins_buf[ins_len] = lower(line_[pos_]);
+        ++ins_len;
+        ++pos_;
+    }
+    std::string long_ins; // Not a valid mnemonic, but keep it for the error message
+    if (ins_len > sizeof(ins_buf)) {
+        for (size_t i = ins_start; i < pos_; ++i)
+            long_ins.push_back(lower(line_[i]));
+    }
+    const std::string_view ins_str = long_ins.empty() ? std::string_view { ins_buf, ins_len } : std::string_view { long_ins };
+
+    const auto opcode = [&]() {
+        try {
+            return opcode_from_string(ins_str);
+        } catch (const std::runtime_error& e) {
+            pos_ = ins_start;
+            error(e.what());
+        }
+    }();
 
     if (pos_ < line_.size() && line_[pos_] == '.') {
         ++pos_;
@@ -282,8 +459,6 @@ std::optional<instruction> parser::do_parse()
             error("Unrecognized suffix");
     }
 
-    //if (!label.empty()) std::cout << "Label  \"" << label << "\"\t";
-
     skip_space();
 
     std::optional<ea> ea1 {}, ea2 {};
@@ -296,10 +471,15 @@ std::optional<instruction> parser::do_parse()
         }
     }
     if (!!ea1 + !!ea2 != num_ea(opcode))
-        error("Invalid numeber of operands for " + ins_str + " expected " + std::to_string(num_ea(opcode)));
+        error("Invalid numeber of operands for " + std::string { ins_str } + " expected " + std::to_string(num_ea(opcode)));
+    if (opcode == ::opcode::lea) {
+        const auto m = ea1->val() >> ea_m_shift;
+        if (!ea1->is_mem() || m == ea_m_A_ind_post || m == ea_m_A_ind_pre || (ea2->val() >> ea_m_shift) != ea_m_An)
+            error("Invalid operands for lea");
+    }
 
     if (pos_ < line_.size())
-        error("Junk at end of line: \"" + line_.substr(pos_) + "\"");
+        error("Junk at end of line: \"" + std::string { line_.substr(pos_) } + "\"");
 
     if (ea2)
         return instruction { opcode, suffix, *ea1, *ea2 };
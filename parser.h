@@ -3,25 +3,79 @@
 
 #include <istream>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <vector>
+#include <stdexcept>
 #include "ea.h"
-#include "instruction.h"
+#include "packed_instruction.h"
+
+// Thrown for syntax errors, what() is the complete message including the location
+class parse_error : public std::runtime_error {
+public:
+    explicit parse_error(const std::string& what, const std::string& message, size_t line, size_t column)
+        : std::runtime_error { what }
+        , message_ { message }
+        , line_ { line }
+        , column_ { column }
+    {
+    }
+
+    const std::string& message() const
+    {
+        return message_;
+    }
+
+    size_t line() const
+    {
+        return line_;
+    }
+
+    size_t column() const
+    {
+        return column_;
+    }
+
+private:
+    std::string message_;
+    size_t line_;
+    size_t column_;
+};
+
+// Parses text (e.g. a mapped_file) in chunks of at least min_chunk_size bytes on
+// several threads. Errors are reported with the correct line numbers, if there
+// are several the one earliest in the text is thrown.
+instruction_arena parse_parallel(std::string_view text, unsigned num_threads = 0, size_t min_chunk_size = 1 << 20);
 
 class parser {
 public:
     explicit parser(std::istream& in);
+    // Parse directly from memory (e.g. a mapped_file), text must outlive the parser
+    // first_line is the line number used for the first line of text
+    explicit parser(std::string_view text, size_t first_line = 1);
 
     std::optional<instruction> next();
     std::vector<instruction> all();
+    // All instructions in packed form, pre-sized from the number of lines when parsing from memory
+    instruction_arena all_packed();
+
+    // Line number of the instruction last returned by next()
+    size_t line_number() const
+    {
+        return line_num_ - 1;
+    }
 
 private:
-    std::istream& in_;
-    std::string line_;
+    std::istream* in_ = nullptr;
+    std::string buffer_; // Only used when reading from in_
+    std::string_view text_; // Remaining text when parsing from memory
+    std::string_view line_;
     size_t line_num_ = 1;
     size_t pos_ = 0;
 
+    bool read_line();
     std::optional<instruction> do_parse();
+    std::optional<branch_pattern> parse_branch_annotation();
     void skip_space();
 
     [[noreturn]] void error(const std::string& msg);
@@ -0,0 +1,234 @@
+#include "profile.h"
+#include "cpu_model_060.h"
+#include <ostream>
+#include <algorithm>
+#include <numeric>
+#include <iomanip>
+
+namespace {
+
+pairing_loss loss_of(soep_reason r)
+{
+    switch (r) {
+    case soep_reason::fetch:
+        return pairing_loss::fetch;
+    case soep_reason::soep_class:
+    case soep_reason::poep_class:
+    case soep_reason::soep_cycles:
+        return pairing_loss::classification;
+    case soep_reason::soep_ea:
+        return pairing_loss::ea_mode;
+    case soep_reason::both_mem:
+    case soep_reason::multi_mem:
+        return pairing_loss::memory_operand;
+    case soep_reason::none:
+    case soep_reason::reg_conflict:
+        break;
+    }
+    assert(r == soep_reason::reg_conflict);
+    return pairing_loss::register_conflict;
+}
+
+class profile_sink : public event_sink {
+public:
+    explicit profile_sink(profile_060& p, size_t n, size_t start)
+        : p_ { p }
+        , n_ { n }
+        , start_ { start }
+    {
+    }
+
+    void on(const dispatch_event& e) override
+    {
+        if (e.pos < start_)
+            return;
+        if (e.pipe == oep::poep) {
+            ++p_.poep_issued;
+            p_.poep_busy += e.cycles - e.stall;
+        } else {
+            ++p_.soep_issued;
+        }
+    }
+
+    void on(const stall_event& e) override
+    {
+        if (e.pos < start_)
+            return;
+        p_.stall_cycles += e.cycles;
+        p_.stall_by_reg[static_cast<int>(e.reg)] += e.cycles;
+        p_.stall_by_producer[e.producer % n_] += e.cycles;
+        p_.stall_by_consumer[e.pos % n_] += e.cycles;
+    }
+
+    void on(const fetch_stall_event& e) override
+    {
+        if (e.pos < start_)
+            return;
+        p_.fetch_stall_cycles += e.cycles;
+        p_.fetch_stall_by_inst[e.pos % n_] += e.cycles;
+    }
+
+    void on(const data_cache_miss_event& e) override
+    {
+        if (e.pos < start_)
+            return;
+        p_.data_cache_stall_cycles += e.cycles;
+        p_.data_cache_misses += e.misses;
+        p_.data_cache_stall_by_inst[e.pos % n_] += e.cycles;
+    }
+
+    void on(const branch_event& e) override
+    {
+        if (e.pos < start_)
+            return;
+        p_.branch_cycles += e.cycles;
+        p_.mispredicts += e.taken != e.predicted_taken;
+    }
+
+    void on(const soep_idle_event& e) override
+    {
+        if (e.pos < start_)
+            return;
+        ++p_.idle_slots;
+        ++p_.idle_by_loss[static_cast<int>(loss_of(e.check.reason))];
+        ++p_.idle_by_poep[e.pos % n_];
+        p_.idle_check[e.pos % n_] = e.check;
+    }
+
+private:
+    profile_060& p_;
+    size_t n_;
+    size_t start_;
+};
+
+// Indices of the non-zero counts, largest first
+template<typename Counts>
+std::vector<size_t> ranked(const Counts& counts, size_t n)
+{
+    std::vector<size_t> idx;
+    for (size_t i = 0; i < n; ++i) {
+        if (counts[i])
+            idx.push_back(i);
+    }
+    std::stable_sort(idx.begin(), idx.end(), [&](size_t l, size_t r) { return counts[l] > counts[r]; });
+    return idx;
+}
+
+constexpr size_t max_listed = 10;
+
+} // unnamed namespace
+
+std::ostream& operator<<(std::ostream& os, pairing_loss l)
+{
+    switch (l) {
+    case pairing_loss::fetch:
+        return os << "instruction fetch";
+    case pairing_loss::classification:
+        return os << "classification";
+    case pairing_loss::ea_mode:
+        return os << "EA mode";
+    case pairing_loss::memory_operand:
+        return os << "memory operand";
+    case pairing_loss::register_conflict:
+        return os << "register conflict";
+    }
+    return os << "pairing_loss{" << static_cast<int>(l) << "}";
+}
+
+profile_060 make_profile_060(instruction_view insts, const options_060& opts)
+{
+    const size_t n = insts.size();
+    profile_060 p {};
+    p.stall_by_producer.resize(n);
+    p.stall_by_consumer.resize(n);
+    p.fetch_stall_by_inst.resize(n);
+    p.data_cache_stall_by_inst.resize(n);
+    p.idle_by_poep.resize(n);
+    p.idle_check.resize(n);
+    if (!n)
+        return p;
+
+    std::ostream null_os { nullptr };
+    auto cpu = make_cpu_model_060(null_os, insts, opts);
+    p.ss = cpu->find_steady_state();
+    profile_sink sink { p, n, p.ss.prologue_iterations * n };
+    cpu->simulate(p.ss.prologue_iterations + p.ss.period_iterations - 1, sink);
+    return p;
+}
+
+void print_profile(const profile_060& p, instruction_view insts, std::ostream& os)
+{
+    const auto cycles = p.ss.period_cycles;
+    if (!cycles)
+        return;
+    auto percent = [&](int count) {
+        return std::to_string(count * 100 / cycles) + "%";
+    };
+    auto print_inst = [&](size_t i) {
+        os << "#" << i << " " << insts[i];
+    };
+
+    os << "\nProfile over " << p.ss.period_iterations << " iteration(s) after warm-up, " << cycles << " cycles\n";
+    os << "pOEP busy " << p.poep_busy << " cycles (" << percent(p.poep_busy) << "), ";
+    os << "sOEP issued " << p.soep_issued << " (" << percent(p.soep_issued) << "), ";
+    os << p.soep_issued << " of " << p.poep_issued << " pOEP instructions paired\n";
+
+    if (p.stall_cycles) {
+        os << "Change/use stalls: " << p.stall_cycles << " cycles (" << percent(p.stall_cycles) << ")\n";
+        for (const auto r : ranked(p.stall_by_reg, 16))
+            os << "\t" << std::setw(4) << p.stall_by_reg[r] << "  waiting for " << static_cast<eareg>(r) << "\n";
+        os << "Stall cycles by producing instruction:\n";
+        const auto producers = ranked(p.stall_by_producer, insts.size());
+        for (size_t k = 0; k < producers.size() && k < max_listed; ++k) {
+            os << "\t" << std::setw(4) << p.stall_by_producer[producers[k]] << "  ";
+            print_inst(producers[k]);
+            os << "\n";
+        }
+        os << "Stall cycles by stalled instruction:\n";
+        const auto consumers = ranked(p.stall_by_consumer, insts.size());
+        for (size_t k = 0; k < consumers.size() && k < max_listed; ++k) {
+            os << "\t" << std::setw(4) << p.stall_by_consumer[consumers[k]] << "  ";
+            print_inst(consumers[k]);
+            os << "\n";
+        }
+    }
+
+    if (p.fetch_stall_cycles) {
+        os << "Instruction fetch stalls: " << p.fetch_stall_cycles << " cycles (" << percent(p.fetch_stall_cycles) << ")\n";
+        const auto stalled = ranked(p.fetch_stall_by_inst, insts.size());
+        for (size_t k = 0; k < stalled.size() && k < max_listed; ++k) {
+            os << "\t" << std::setw(4) << p.fetch_stall_by_inst[stalled[k]] << "  ";
+            print_inst(stalled[k]);
+            os << "\n";
+        }
+    }
+
+    if (p.data_cache_stall_cycles) {
+        os << "Data cache miss stalls: " << p.data_cache_stall_cycles << " cycles (" << percent(p.data_cache_stall_cycles) << "), " << p.data_cache_misses << " line fills\n";
+        const auto stalled = ranked(p.data_cache_stall_by_inst, insts.size());
+        for (size_t k = 0; k < stalled.size() && k < max_listed; ++k) {
+            os << "\t" << std::setw(4) << p.data_cache_stall_by_inst[stalled[k]] << "  ";
+            print_inst(stalled[k]);
+            os << "\n";
+        }
+    }
+
+    if (p.branch_cycles)
+        os << "Branches: " << p.branch_cycles << " cycles (" << percent(p.branch_cycles) << "), " << p.mispredicts << " mispredicted\n";
+
+    if (p.idle_slots) {
+        os << "sOEP idle slots: " << p.idle_slots << "\n";
+        for (const auto l : ranked(p.idle_by_loss, num_pairing_losses))
+            os << "\t" << std::setw(4) << p.idle_by_loss[l] << "  " << static_cast<pairing_loss>(l) << "\n";
+        os << "sOEP idle slots by pOEP instruction:\n";
+        const auto poep = ranked(p.idle_by_poep, insts.size());
+        for (size_t k = 0; k < poep.size() && k < max_listed; ++k) {
+            const auto i = poep[k];
+            os << "\t" << std::setw(4) << p.idle_by_poep[i] << "  ";
+            print_inst(i);
+            os << " (";
+            print_reason(os, p.idle_check[i], insts[i], insts[(i + 1) % insts.size()]);
+            os << ")\n";
+        }
+    }
+}
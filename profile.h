@@ -0,0 +1,49 @@
+#ifndef PROFILE_H_INCLUDED
+#define PROFILE_H_INCLUDED
+
+#include <vector>
+#include <iosfwd>
+#include "cpu_model_060.h"
+#include "packed_instruction.h"
+
+// Why an sOEP slot was lost, grouped by dispatch test
+enum class pairing_loss {
+    fetch, // 10.1.1
+    classification, // 10.1.2
+    ea_mode, // 10.1.3
+    memory_operand, // 10.1.4
+    register_conflict, // 10.1.5/10.1.6
+};
+constexpr int num_pairing_losses = 5;
+std::ostream& operator<<(std::ostream& os, pairing_loss l);
+
+// Where the cycles of a loop go on the 68060, measured over one period of
+// the steady state (i.e. after warm-up)
+struct profile_060 {
+    steady_state ss;
+    int poep_busy; // Cycles the pOEP executed an instruction
+    int poep_issued;
+    int soep_issued;
+    int stall_cycles;
+    int idle_slots;
+    int branch_cycles; // Cycles of branches that weren't folded
+    int mispredicts;
+    int stall_by_reg[16]; // Change/use stall cycles waiting for d0..d7/a0..a7
+    std::vector<int> stall_by_producer; // Per instruction of the loop
+    std::vector<int> stall_by_consumer; // Per instruction of the loop
+    int fetch_stall_cycles;
+    std::vector<int> fetch_stall_by_inst; // Per instruction of the loop
+    int data_cache_stall_cycles;
+    int data_cache_misses; // Lines filled
+    std::vector<int> data_cache_stall_by_inst; // Per instruction of the loop
+    int idle_by_loss[num_pairing_losses];
+    std::vector<int> idle_by_poep; // Per instruction of the loop
+    std::vector<soep_check> idle_check; // Last reason seen per pOEP instruction
+};
+
+profile_060 make_profile_060(instruction_view insts, const options_060& opts = {});
+
+// Ranked report, most expensive first
+void print_profile(const profile_060& p, instruction_view insts, std::ostream& os);
+
+#endif
@@ -0,0 +1,122 @@
+#include "result_cache.h"
+#include "analysis.h"
+#include "util.h"
+#include "stats.h"
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <atomic>
+#include <random>
+
+#ifndef ACYCLES_MODEL_VERSION
+#define ACYCLES_MODEL_VERSION "unknown"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Two 64-bit FNV-1a hashes with different offsets
+class hasher {
+public:
+    void add(uint64_t val, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i, val >>= 8) {
+            for (auto& h : h_) {
+                h ^= val & 0xff;
+                h *= 0x100000001b3ULL;
+            }
+        }
+    }
+
+    void add(const std::string& s)
+    {
+        add(s.size(), 4);
+        for (const char ch : s)
+            add(static_cast<uint8_t>(ch), 1);
+    }
+
+    std::string str() const
+    {
+        return hexstring(h_[0]) + hexstring(h_[1]);
+    }
+
+private:
+    uint64_t h_[2] = { 0xcbf29ce484222325ULL, 0x84222325cbf29ce4ULL };
+};
+
+} // unnamed namespace
+
+const char* model_version()
+{
+    return ACYCLES_MODEL_VERSION;
+}
+
+std::string result_key(instruction_view insts, const analysis_options& opts)
+{
+    hasher h;
+    h.add(model_version());
+    h.add(opts.model, 4);
+    h.add(static_cast<int>(opts.format), 1);
+    h.add(opts.unroll, 4);
+    h.add(opts.profile, 1);
+    h.add(opts.cpu_060.fetch_bytes_per_cycle, 4);
+    h.add(opts.cpu_060.instruction_buffer_bytes, 4);
+    h.add(opts.cpu_060.branch_cache_entries, 4);
+    h.add(opts.cpu_060.data_cache_bytes, 4);
+    h.add(opts.cpu_060.data_cache_ways, 4);
+    h.add(opts.cpu_060.line_fill_cycles, 4);
+    h.add(opts.cpu_060.write_allocate, 1);
+    h.add(insts.size(), 8);
+    for (size_t n = 0; n < insts.size(); ++n) {
+        const auto i = insts[n];
+        h.add(static_cast<int>(i.op()), 1);
+        h.add(i.opsize(), 1);
+        for (int n = 0; n < num_ea(i.op()); ++n) {
+            const auto& e = i.arg(n);
+            h.add(e.val(), 1);
+            h.add(ea_has_extra(e.val()) ? e.extra() : 0, 4);
+        }
+        h.add(i.branch().taken, 4);
+        h.add(i.branch().length, 1);
+    }
+    return h.str();
+}
+
+result_cache::result_cache(const std::string& dir)
+    : dir_ { dir }
+{
+    fs::create_directories(dir_);
+}
+
+std::optional<std::string> result_cache::get(const std::string& key) const
+{
+    std::ifstream in { fs::path { dir_ } / key, std::ios::binary };
+    if (!in) {
+        count_stat(stat_counter::disk_cache_misses);
+        return {};
+    }
+    count_stat(stat_counter::disk_cache_hits);
+    std::ostringstream oss;
+    oss << in.rdbuf();
+    return oss.str();
+}
+
+void result_cache::put(const std::string& key, const std::string& value) const
+{
+    // Write to a temporary file first so readers (and other processes) never see a partial entry
+    static const uint32_t process_id = std::random_device {}();
+    static std::atomic<uint32_t> counter;
+    const auto path = fs::path { dir_ } / key;
+    auto tmp = path;
+    tmp += ".tmp" + hexstring(process_id) + hexstring(counter++);
+    {
+        std::ofstream out { tmp, std::ios::binary };
+        if (!out || !(out << value))
+            throw std::runtime_error { "Could not write cache entry " + tmp.string() };
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec)
+        fs::remove(tmp, ec);
+}
@@ -0,0 +1,29 @@
+#ifndef RESULT_CACHE_H_INCLUDED
+#define RESULT_CACHE_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <optional>
+#include "packed_instruction.h"
+
+struct analysis_options;
+
+// Stamp that changes whenever the sources of the models change (computed by CMake)
+const char* model_version();
+
+// Identifies the result of analysing insts with opts using the current model version
+std::string result_key(instruction_view insts, const analysis_options& opts);
+
+// Content-addressed on-disk cache, one file per key
+class result_cache {
+public:
+    explicit result_cache(const std::string& dir);
+
+    std::optional<std::string> get(const std::string& key) const;
+    void put(const std::string& key, const std::string& value) const;
+
+private:
+    std::string dir_;
+};
+
+#endif
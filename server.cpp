@@ -0,0 +1,250 @@
+#include "server.h"
+#include "parser.h"
+#include "result_cache.h"
+#include "stats.h"
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <thread>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+template<typename T>
+const T* analysis_server::lru_map<T>::get(const std::string& key)
+{
+    auto it = index_.find(key);
+    if (it == index_.end())
+        return nullptr;
+    items_.splice(items_.begin(), items_, it->second);
+    return &it->second->second;
+}
+
+template<typename T>
+void analysis_server::lru_map<T>::put(const std::string& key, const T& value)
+{
+    if (auto it = index_.find(key); it != index_.end()) {
+        items_.erase(it->second);
+        index_.erase(it);
+    }
+    items_.emplace_front(key, value);
+    index_[key] = items_.begin();
+    if (items_.size() > max_size_) {
+        index_.erase(items_.back().first);
+        items_.pop_back();
+    }
+}
+
+analysis_server::analysis_server(const analysis_options& defaults, const result_cache* disk_cache, size_t max_entries)
+    : defaults_ { defaults }
+    , disk_cache_ { disk_cache }
+    , parsed_ { max_entries }
+    , results_ { max_entries }
+{
+}
+
+std::string analysis_server::analyse_source(const std::string& source, const analysis_options& opts)
+{
+    std::vector<instruction> insts;
+    {
+        std::lock_guard<std::mutex> lock { mutex_ };
+        if (auto p = parsed_.get(source)) {
+            insts = *p;
+            count_stat(stat_counter::server_parse_hits);
+        } else {
+            count_stat(stat_counter::server_parse_misses);
+        }
+    }
+    if (insts.empty() && !source.empty()) {
+        insts = parser { source }.all();
+        std::lock_guard<std::mutex> lock { mutex_ };
+        parsed_.put(source, insts);
+    }
+
+    const auto key = result_key(insts, opts);
+    {
+        std::lock_guard<std::mutex> lock { mutex_ };
+        if (auto r = results_.get(key)) {
+            count_stat(stat_counter::server_result_hits);
+            return *r;
+        }
+        count_stat(stat_counter::server_result_misses);
+    }
+
+    std::string res;
+    if (auto r = disk_cache_ ? disk_cache_->get(key) : std::nullopt) {
+        res = *r;
+    } else {
+        std::ostringstream oss;
+        analyse(insts, opts, oss);
+        res = oss.str();
+        if (disk_cache_)
+            disk_cache_->put(key, res);
+    }
+    std::lock_guard<std::mutex> lock { mutex_ };
+    results_.put(key, res);
+    return res;
+}
+
+void analysis_server::serve(std::istream& in, std::ostream& out)
+{
+    auto reply = [&out](const char* status, const std::string& payload) {
+        out << status << " " << payload.size() << "\n"
+            << payload << std::flush;
+    };
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream iss { line };
+        std::string cmd;
+        if (!(iss >> cmd))
+            continue;
+        if (cmd == "quit")
+            return;
+        if (cmd != "analyse") {
+            reply("error", "Unknown command \"" + cmd + "\"\n");
+            continue;
+        }
+
+        analysis_options opts = defaults_;
+        std::string error;
+        size_t num_lines = 0;
+        for (std::string arg; iss >> arg;) {
+            if (arg.find_first_not_of("0123456789") == std::string::npos) {
+                // Anything longer can't be a sensible request, and the lines can't be skipped either
+                if (arg.size() > 6) {
+                    reply("error", "Invalid line count " + arg + "\n");
+                    return;
+                }
+                num_lines = std::stoul(arg);
+                continue;
+            }
+            try {
+                if (!parse_analysis_option(arg, opts))
+                    error = "Unknown option \"" + arg + "\"\n";
+            } catch (const std::exception& e) {
+                error = std::string { e.what() } + "\n";
+            }
+        }
+
+        std::string source;
+        for (size_t i = 0; i < num_lines && std::getline(in, line); ++i) {
+            source += line;
+            source += '\n';
+        }
+        if (!error.empty()) {
+            reply("error", error);
+            continue;
+        }
+        try {
+            reply("ok", analyse_source(source, opts));
+        } catch (const std::exception& e) {
+            reply("error", std::string { e.what() } + "\n");
+        }
+    }
+}
+
+#ifdef _WIN32
+void analysis_server::listen(const std::string&)
+{
+    throw std::runtime_error { "Unix sockets are not supported on this platform" };
+}
+#else
+namespace {
+
+// Minimal streambuf for a socket
+class fd_streambuf : public std::streambuf {
+public:
+    explicit fd_streambuf(int fd)
+        : fd_ { fd }
+    {
+        setg(in_, in_, in_);
+        setp(out_, out_ + sizeof(out_));
+    }
+
+    ~fd_streambuf()
+    {
+        sync();
+    }
+
+protected:
+    int_type underflow() override
+    {
+        const auto n = ::read(fd_, in_, sizeof(in_));
+        if (n <= 0)
+            return traits_type::eof();
+        setg(in_, in_, in_ + n);
+        return traits_type::to_int_type(in_[0]);
+    }
+
+    int_type overflow(int_type ch) override
+    {
+        if (sync() < 0)
+            return traits_type::eof();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync() override
+    {
+        for (const char* p = pbase(); p < pptr();) {
+            // No SIGPIPE if the client has gone, the connection just ends
+            const auto n = ::send(fd_, p, pptr() - p, MSG_NOSIGNAL);
+            if (n <= 0)
+                return -1;
+            p += n;
+        }
+        setp(out_, out_ + sizeof(out_));
+        return 0;
+    }
+
+private:
+    int fd_;
+    char in_[4096];
+    char out_[4096];
+};
+
+} // unnamed namespace
+
+void analysis_server::listen(const std::string& socket_path)
+{
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path))
+        throw std::runtime_error { "Socket path too long: " + socket_path };
+    std::strcpy(addr.sun_path, socket_path.c_str());
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        throw std::runtime_error { "Could not create socket" };
+    ::unlink(socket_path.c_str());
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, 16) < 0) {
+        ::close(fd);
+        throw std::runtime_error { "Could not listen on " + socket_path };
+    }
+
+    for (;;) {
+        const int conn = ::accept(fd, nullptr, nullptr);
+        if (conn < 0)
+            continue;
+        std::thread { [this, conn]() {
+            // Whatever goes wrong only ends this connection
+            try {
+                fd_streambuf buf { conn };
+                std::iostream stream { &buf };
+                serve(stream, stream);
+            } catch (...) {
+            }
+            ::close(conn);
+        } }.detach();
+    }
+}
+#endif
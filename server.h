@@ -0,0 +1,61 @@
+#ifndef SERVER_H_INCLUDED
+#define SERVER_H_INCLUDED
+
+#include <string>
+#include <iosfwd>
+#include <mutex>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "analysis.h"
+
+class result_cache;
+
+// Resident analysis server, keeps parsed loops and results warm between requests.
+//
+// Protocol (one request after another on the same stream):
+//   analyse [options] <n>    followed by n lines of source
+//   quit
+// The options are the analysis options of the command line (-68020, --format=json,
+// --unroll=N, --dcache, ...) and override the server's defaults for that request.
+// Each request is answered by "ok <bytes>" or "error <bytes>" followed by
+// exactly that many bytes of report/error message.
+class analysis_server {
+public:
+    explicit analysis_server(const analysis_options& defaults = {}, const result_cache* disk_cache = nullptr, size_t max_entries = 4096);
+
+    // Report for source analysed with opts (throws on errors)
+    std::string analyse_source(const std::string& source, const analysis_options& opts);
+
+    // Handle requests until end of input or quit
+    void serve(std::istream& in, std::ostream& out);
+
+    // Accept connections on a Unix socket, each is served on its own thread
+    [[noreturn]] void listen(const std::string& socket_path);
+
+private:
+    template<typename T>
+    class lru_map {
+    public:
+        explicit lru_map(size_t max_size)
+            : max_size_ { max_size }
+        {
+        }
+
+        const T* get(const std::string& key);
+        void put(const std::string& key, const T& value);
+
+    private:
+        size_t max_size_;
+        std::list<std::pair<std::string, T>> items_; // Most recently used first
+        std::unordered_map<std::string, typename std::list<std::pair<std::string, T>>::iterator> index_;
+    };
+
+    analysis_options defaults_;
+    const result_cache* disk_cache_;
+    std::mutex mutex_;
+    lru_map<std::vector<instruction>> parsed_; // Source text -> instructions
+    lru_map<std::string> results_; // result_key -> report
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef SIM_EVENTS_H_INCLUDED
+#define SIM_EVENTS_H_INCLUDED
+
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+#include "ea.h"
+
+class instruction;
+
+// Events emitted by the CPU models while simulating.
+//
+// The simulators take the sink as a template parameter and call sink.on(event) for each
+// event, so with null_sink the calls (and building the events) compile away.
+// Sinks living outside the library derive from event_sink instead.
+
+struct cycle_counts {
+    int best;
+    int cache;
+    int worst;
+
+    cycle_counts& operator+=(const cycle_counts& r)
+    {
+        best += r.best;
+        cache += r.cache;
+        worst += r.worst;
+        return *this;
+    }
+};
+
+inline cycle_counts operator+(const cycle_counts& l, const cycle_counts& r)
+{
+    cycle_counts cc = l;
+    return cc += r;
+}
+
+std::ostream& operator<<(std::ostream& os, const cycle_counts& cc);
+
+enum class oep {
+    poep,
+    soep,
+};
+std::ostream& operator<<(std::ostream& os, oep o);
+
+// Why an instruction can't be dispatched to the sOEP
+enum class soep_reason : uint8_t {
+    none,
+    fetch, // 10.1.1
+    soep_class, // 10.1.2
+    poep_class, // 10.1.2
+    soep_cycles, // 10.1.2 (sOEP instructions complete in one cycle)
+    soep_ea, // 10.1.3
+    both_mem, // 10.1.4
+    multi_mem, // 10.1.4
+    reg_conflict, // 10.1.5/10.1.6
+};
+
+struct soep_check {
+    soep_reason reason = soep_reason::none;
+    int8_t arg = -1; // Offending operand of the sOEP instruction (soep_ea)
+    eareg reg = eareg::d0; // Conflicting register (reg_conflict)
+};
+
+void print_reason(std::ostream& os, const soep_check& c, const instruction& p, const instruction& s);
+
+// 68060: Instruction issued to an OEP
+// cycle/cycles cover the stall cycles before the instruction as well
+struct dispatch_event {
+    size_t pos; // Position in the (unrolled) instruction stream
+    const instruction& inst;
+    oep pipe;
+    int cycle;
+    int cycles;
+    int stall;
+};
+
+// 68060: Change/use stall before dispatch
+struct stall_event {
+    size_t pos; // Stalled instruction
+    oep pipe;
+    eareg reg;
+    int cycles;
+    size_t producer; // Position of the instruction that changed reg
+};
+
+// 68060: Dispatch waited for the pOEP instruction to be fetched into the instruction buffer
+struct fetch_stall_event {
+    size_t pos;
+    int cycles;
+    int buffered; // Bytes that were in the buffer
+};
+
+// 68060: Dispatch waited for the data cache lines the operands of an instruction missed
+struct data_cache_miss_event {
+    size_t pos;
+    oep pipe;
+    int misses; // Lines filled
+    int cycles;
+};
+
+// 68060: Nothing dispatched to the sOEP
+struct soep_idle_event {
+    size_t pos; // Of the pOEP instruction
+    const instruction& poep_inst;
+    const instruction& soep_inst;
+    soep_check check;
+};
+
+// 68060: Branch, cycles is 0 if it was folded (correctly predicted taken)
+struct branch_event {
+    size_t pos;
+    const instruction& inst;
+    int cycle;
+    int cycles;
+    bool taken;
+    bool predicted_taken;
+    bool cache_hit;
+};
+
+// 68060: Simulation moved on to a new cycle
+struct cycle_event {
+    int cycle;
+};
+
+// 68020: Cost of one instruction
+struct cost_event {
+    size_t pos;
+    const instruction& inst;
+    cycle_counts cost;
+    bool assumed_taken; // Branch (or dbra) without @branch annotation
+    bool taken; // Branch (or dbra) taken in this iteration
+};
+
+// End of simulation, cycles is the total for all unroll+1 iterations
+// (68020: total is for the first iteration)
+struct end_event {
+    int unroll;
+    int cycles;
+    cycle_counts total; // 68020 only
+};
+
+struct null_sink {
+    template<typename Event>
+    void on(const Event&)
+    {
+    }
+};
+
+class event_sink {
+public:
+    virtual ~event_sink() {}
+    virtual void on(const dispatch_event&) {}
+    virtual void on(const stall_event&) {}
+    virtual void on(const fetch_stall_event&) {}
+    virtual void on(const data_cache_miss_event&) {}
+    virtual void on(const soep_idle_event&) {}
+    virtual void on(const branch_event&) {}
+    virtual void on(const cycle_event&) {}
+    virtual void on(const cost_event&) {}
+    virtual void on(const end_event&) {}
+};
+
+#endif
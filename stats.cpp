@@ -0,0 +1,60 @@
+#include "stats.h"
+#include <ostream>
+#include <iomanip>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+tool_stats* active_tool_stats;
+
+namespace {
+
+const char* const phase_names[num_stat_phases] = {
+    "parse",
+    "construct_020",
+    "construct_060",
+    "simulate_020",
+    "simulate_060",
+    "steady_state_060",
+};
+
+void print_hit_rate(std::ostream& os, const char* name, uint64_t hits, uint64_t misses)
+{
+    if (!hits && !misses)
+        return;
+    os << name << ": " << hits << " hits, " << misses << " misses (" << hits * 100 / (hits + misses) << "% hit rate)\n";
+}
+
+} // unnamed namespace
+
+void tool_stats::print(std::ostream& os) const
+{
+    os << std::left << std::setw(18) << "phase" << std::right << std::setw(8) << "calls" << std::setw(12) << "time_ms" << std::setw(12) << "items" << std::setw(14) << "items/s" << "\n";
+    for (int p = 0; p < num_stat_phases; ++p) {
+        const auto& ps = phases_[p];
+        if (!ps.calls)
+            continue;
+        const double seconds = ps.nanoseconds / 1e9;
+        os << std::left << std::setw(18) << phase_names[p] << std::right << std::setw(8) << ps.calls;
+        os << std::setw(12) << std::fixed << std::setprecision(3) << seconds * 1000 << std::defaultfloat;
+        os << std::setw(12) << ps.items << std::setw(14) << static_cast<uint64_t>(seconds > 0 ? ps.items / seconds : 0) << "\n";
+    }
+
+#ifndef _WIN32
+    rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        const long peak_kb = usage.ru_maxrss / 1024;
+#else
+        const long peak_kb = usage.ru_maxrss;
+#endif
+        os << "Peak resident memory: " << peak_kb << " KB\n";
+    }
+#endif
+
+    auto counter = [&](stat_counter c) { return counters_[static_cast<int>(c)].load(); };
+    print_hit_rate(os, "Result cache", counter(stat_counter::disk_cache_hits), counter(stat_counter::disk_cache_misses));
+    print_hit_rate(os, "Server parse cache", counter(stat_counter::server_parse_hits), counter(stat_counter::server_parse_misses));
+    print_hit_rate(os, "Server result cache", counter(stat_counter::server_result_hits), counter(stat_counter::server_result_misses));
+}
@@ -0,0 +1,102 @@
+#ifndef STATS_H_INCLUDED
+#define STATS_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+// Self-profiling counters for --stats.
+//
+// Instrumented code only checks active_tool_stats, which is null unless stats
+// were requested, so the counters cost a load and a branch per phase when off.
+// The counters are atomic since batch mode runs files on several threads.
+
+enum class stat_phase {
+    parse,
+    construct_020,
+    construct_060,
+    simulate_020,
+    simulate_060,
+    steady_state_060,
+};
+constexpr int num_stat_phases = 6;
+
+enum class stat_counter {
+    disk_cache_hits,
+    disk_cache_misses,
+    server_parse_hits,
+    server_parse_misses,
+    server_result_hits,
+    server_result_misses,
+};
+constexpr int num_stat_counters = 6;
+
+class tool_stats {
+public:
+    void add(stat_phase p, std::chrono::steady_clock::duration time, uint64_t items)
+    {
+        auto& ps = phases_[static_cast<int>(p)];
+        ++ps.calls;
+        ps.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+        ps.items += items;
+    }
+
+    void count(stat_counter c)
+    {
+        ++counters_[static_cast<int>(c)];
+    }
+
+    void print(std::ostream& os) const;
+
+private:
+    struct phase_stats {
+        std::atomic<uint64_t> calls;
+        std::atomic<uint64_t> nanoseconds;
+        std::atomic<uint64_t> items; // Instructions parsed/simulated
+    };
+    phase_stats phases_[num_stat_phases] {};
+    std::atomic<uint64_t> counters_[num_stat_counters] {};
+};
+
+extern tool_stats* active_tool_stats;
+
+inline void count_stat(stat_counter c)
+{
+    if (active_tool_stats)
+        active_tool_stats->count(c);
+}
+
+// Adds the time from construction to destruction to a phase
+class stat_timer {
+public:
+    explicit stat_timer(stat_phase p)
+        : stats_ { active_tool_stats }
+        , phase_ { p }
+    {
+        if (stats_)
+            start_ = std::chrono::steady_clock::now();
+    }
+
+    ~stat_timer()
+    {
+        if (stats_)
+            stats_->add(phase_, std::chrono::steady_clock::now() - start_, items_);
+    }
+
+    stat_timer(const stat_timer&) = delete;
+    stat_timer& operator=(const stat_timer&) = delete;
+
+    void items(uint64_t n)
+    {
+        items_ = n;
+    }
+
+private:
+    tool_stats* stats_;
+    stat_phase phase_;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t items_ = 0;
+};
+
+#endif
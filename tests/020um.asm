@@ -1,7 +1,8 @@
-    MULU.L  D7,D1       ;45
-    DIVS.L #$10000,D3   ;96
+; @020.loop 140/158/168 @060.loop 43
+    MULU.L  D7,D1       ;45 @020 41/45/47 @060 pOEP
+    DIVS.L #$10000,D3   ;96 @020 89/98/101 @060 pOEP
 
-    MOVE.L D4,(A1)+     ;4/4/6
-    ADD.L D4,D5         ;0/2/3
-    MOVE.L (A1),-(A2)   ;6/7/9
-    ADD.L D5,D6         ;0/2/3
+    MOVE.L D4,(A1)+     ;4/4/6 @020 4/4/5 @060 pOEP
+    ADD.L D4,D5         ;0/2/3 @020 0/2/3 @060 sOEP
+    MOVE.L (A1),-(A2)   ;6/7/9 @020 6/7/9 @060 pOEP
+    ADD.L D5,D6         ;0/2/3 @020 0/2/3 @060 sOEP
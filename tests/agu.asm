@@ -0,0 +1,17 @@
+; Address generation: move.l and lea results are available to the AGU a cycle
+; early (10.2.3), and a register updated by (An)+ doesn't stall later address
+; generation but can't be used by the sOEP in the same cycle. When both OEPs
+; wait for a register the group waits for the longer stall.
+; @020.loop 23/51/68 @060.loop 8
+.loop:
+        move.l  d0,a1           ; @020 0/2/3 @060 pOEP
+        add.l   a5,a3           ; @020 0/2/3 @060 sOEP
+        add.l   (a1),d1         ; @020 3/6/7 @060 pOEP
+        lea     4(a3),a4        ; @020 3/4/6 @060 sOEP
+        add.l   (a2)+,d1        ; @020 4/6/7 @060 pOEP
+        move.l  a2,d2           ; @060 pOEP
+        add.l   (a2),d3         ; @060 sOEP
+        add.w   $fff0.w,d4      ; @020 3/6/9 @060 pOEP
+        move.l  8(pc,d5.w*4),d6 ; @020 4/9/11 @060 pOEP
+        subq.l  #1,d7           ; @060 sOEP
+        bne.b   .loop
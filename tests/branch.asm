@@ -0,0 +1,10 @@
+; @020.loop 9/26/37 @060.loop 6.33333
+.loop:
+        move.l  (a0),d1         ; @020 3/6/7 @060 pOEP
+        cmp.l   d2,d1           ; @020 0/2/3 @060 sOEP
+        bne.b   .skip           ; @branch TTN @020 3/6/9
+        addq.l  #1,d3           ; @020 0/2/3
+.skip:
+        addq.l  #4,a0           ; @020 0/2/3
+        subq.l  #1,d0           ; @020 0/2/3
+        bne.b   .loop           ; @020 3/6/9
@@ -1,154 +1,155 @@
-    MOVEQ.L	#$10,D6
-    MOVE.L	$0010(A0),D4
-    ROL.L	D6,D4
-    MOVE.L	$0014(A0),D5
-    ROL.L	D6,D5
-    MOVE.L	(A0),D0
-    EOR.W	D0,D4
-    MOVE.L	$0004(A0),D1
-    EOR.W	D1,D5
-    EOR.W	D4,D0
-    EOR.W	D5,D1
-    EOR.W	D0,D4
-    EOR.W	D1,D5
-    ROL.L	D6,D4
-    ROL.L	D6,D5
-    MOVE.L	D4,D6
-    MOVE.L	D5,D7
-    LSR.L	#$02,D6
-    LSR.L	#$02,D7
-    EOR.L	D0,D6
-    EOR.L	D1,D7
-    AND.L	#$33333333,D6
-    AND.L	#$33333333,D7
-    EOR.L	D6,D0
-    EOR.L	D7,D1
-    LSL.L	#$02,D6
-    LSL.L	#$02,D7
-    EOR.L	D6,D4
-    EOR.L	D7,D5
-    MOVEA.L	D4,A2
-    MOVEA.L	D5,A3
-    MOVEQ.L	#$10,D6
-    MOVE.L	$0018(A0),D4
-    ROL.L	D6,D4
-    MOVE.L	$001c(A0),D5
-    ROL.L	D6,D5
-    MOVE.L	$0008(A0),D2
-    EOR.W	D2,D4
-    MOVE.L	$000c(A0),D3
-    EOR.W	D3,D5
-    EOR.W	D4,D2
-    EOR.W	D5,D3
-    EOR.W	D2,D4
-    EOR.W	D3,D5
-    ROL.L	D6,D4
-    ROL.L	D6,D5
-    MOVE.L	D4,D6
-    MOVE.L	D5,D7
-    LSR.L	#$02,D6
-    LSR.L	#$02,D7
-    EOR.L	D2,D6
-    EOR.L	D3,D7
-    AND.L	#$33333333,D6
-    AND.L	#$33333333,D7
-    EOR.L	D6,D2
-    EOR.L	D7,D3
-    LSL.L	#$02,D6
-    LSL.L	#$02,D7
-    EOR.L	D6,D4
-    EOR.L	D7,D5
-    MOVE.L	D2,D6
-    MOVE.L	D3,D7
-    LSR.L	#$08,D6
-    LSR.L	#$08,D7
-    EOR.L	D0,D6
-    EOR.L	D1,D7
-    AND.L	#$00ff00ff,D6
-    AND.L	#$00ff00ff,D7
-    EOR.L	D6,D0
-    EOR.L	D7,D1
-    LSL.L	#$08,D6
-    LSL.L	#$08,D7
-    EOR.L	D6,D2
-    EOR.L	D7,D3
-    MOVE.L	D1,D6
-    MOVE.L	D3,D7
-    LSR.L	#$04,D6
-    LSR.L	#$04,D7
-    EOR.L	D0,D6
-    EOR.L	D2,D7
-    AND.L	#$0f0f0f0f,D6
-    AND.L	#$0f0f0f0f,D7
-    EOR.L	D6,D0
-    EOR.L	D7,D2
-    LSL.L	#$04,D6
-    LSL.L	#$04,D7
-    EOR.L	D6,D1
-    EOR.L	D7,D3
-    MOVE.L	D2,D6
-    MOVE.L	D3,D7
-    LSR.L	#$01,D6
-    LSR.L	#$01,D7
-    EOR.L	D0,D6
-    EOR.L	D1,D7
-    AND.L	#$55555555,D6
-    AND.L	#$55555555,D7
-    EOR.L	D6,D0
-    EOR.L	D7,D1
-    LSL.L	#$01,D6
-    LSL.L	#$01,D7
-    EOR.L	D6,D2
-    EOR.L	D7,D3
-    MOVE.L	D2,$3e80(A1)
-    MOVE.L	D3,$-3e80(A1)
-    MOVE.L	D0,$5dc0(A1)
-    MOVE.L	D1,$-1f40(A1)
-    MOVE.L	A2,D2
-    MOVE.L	A3,D3
-    MOVE.L	D4,D6
-    MOVE.L	D5,D7
-    LSR.L	#$08,D6
-    LSR.L	#$08,D7
-    EOR.L	D2,D6
-    EOR.L	D3,D7
-    AND.L	#$00ff00ff,D6
-    AND.L	#$00ff00ff,D7
-    EOR.L	D6,D2
-    EOR.L	D7,D3
-    LSL.L	#$08,D6
-    LSL.L	#$08,D7
-    EOR.L	D6,D4
-    EOR.L	D7,D5
-    MOVE.L	D3,D6
-    MOVE.L	D5,D7
-    LSR.L	#$04,D6
-    LSR.L	#$04,D7
-    EOR.L	D2,D6
-    EOR.L	D4,D7
-    AND.L	#$0f0f0f0f,D6
-    AND.L	#$0f0f0f0f,D7
-    EOR.L	D6,D2
-    EOR.L	D7,D4
-    LSL.L	#$04,D6
-    LSL.L	#$04,D7
-    EOR.L	D6,D3
-    EOR.L	D7,D5
-    MOVE.L	D4,D6
-    MOVE.L	D5,D7
-    LSR.L	#$01,D6
-    LSR.L	#$01,D7
-    EOR.L	D2,D6
-    EOR.L	D3,D7
-    AND.L	#$55555555,D6
-    AND.L	#$55555555,D7
-    EOR.L	D6,D2
-    EOR.L	D7,D3
-    LSL.L	#$01,D6
-    LSL.L	#$01,D7
-    EOR.L	D6,D4
-    EOR.L	D7,D5
-    MOVE.L	D2,$1f40(A1)
-    MOVE.L	D3,$-5dc0(A1)
-    MOVE.L	D5,$-7d00(A1)
-    MOVE.L	D4,(A1)
+; @020.loop 136/546/690 @060.loop 100
+    MOVEQ.L	#$10,D6         ; @020 0/2/3 @060 pOEP
+    MOVE.L	$0010(A0),D4    ; @020 3/7/9 @060 sOEP
+    ROL.L	D6,D4           ; @020 5/8/8 @060 pOEP
+    MOVE.L	$0014(A0),D5    ; @020 3/7/9 @060 sOEP
+    ROL.L	D6,D5           ; @020 5/8/8 @060 pOEP
+    MOVE.L	(A0),D0         ; @020 3/6/7 @060 sOEP
+    EOR.W	D0,D4           ; @020 0/2/3 @060 pOEP
+    MOVE.L	$0004(A0),D1    ; @020 3/7/9 @060 sOEP
+    EOR.W	D1,D5           ; @020 0/2/3 @060 pOEP
+    EOR.W	D4,D0           ; @020 0/2/3 @060 sOEP
+    EOR.W	D5,D1           ; @020 0/2/3 @060 pOEP
+    EOR.W	D0,D4           ; @020 0/2/3 @060 sOEP
+    EOR.W	D1,D5           ; @020 0/2/3 @060 pOEP
+    ROL.L	D6,D4           ; @020 5/8/8 @060 sOEP
+    ROL.L	D6,D5           ; @020 5/8/8 @060 pOEP
+    MOVE.L	D4,D6           ; @020 0/2/3 @060 sOEP
+    MOVE.L	D5,D7           ; @020 0/2/3 @060 pOEP
+    LSR.L	#$02,D6         ; @020 1/4/4 @060 sOEP
+    LSR.L	#$02,D7         ; @020 1/4/4 @060 pOEP
+    EOR.L	D0,D6           ; @020 0/2/3 @060 sOEP
+    EOR.L	D1,D7           ; @020 0/2/3 @060 pOEP
+    AND.L	#$33333333,D6   ; @020 1/6/8 @060 sOEP
+    AND.L	#$33333333,D7   ; @020 1/6/8 @060 pOEP
+    EOR.L	D6,D0           ; @020 0/2/3 @060 sOEP
+    EOR.L	D7,D1           ; @020 0/2/3 @060 pOEP
+    LSL.L	#$02,D6         ; @020 1/4/4 @060 sOEP
+    LSL.L	#$02,D7         ; @020 1/4/4 @060 pOEP
+    EOR.L	D6,D4           ; @020 0/2/3 @060 sOEP
+    EOR.L	D7,D5           ; @020 0/2/3 @060 pOEP
+    MOVEA.L	D4,A2           ; @020 0/2/3 @060 sOEP
+    MOVEA.L	D5,A3           ; @020 0/2/3 @060 pOEP
+    MOVEQ.L	#$10,D6         ; @020 0/2/3 @060 sOEP
+    MOVE.L	$0018(A0),D4    ; @020 3/7/9 @060 pOEP
+    ROL.L	D6,D4           ; @020 5/8/8 @060 sOEP
+    MOVE.L	$001c(A0),D5    ; @020 3/7/9 @060 pOEP
+    ROL.L	D6,D5           ; @020 5/8/8 @060 sOEP
+    MOVE.L	$0008(A0),D2    ; @020 3/7/9 @060 pOEP
+    EOR.W	D2,D4           ; @020 0/2/3 @060 sOEP
+    MOVE.L	$000c(A0),D3    ; @020 3/7/9 @060 pOEP
+    EOR.W	D3,D5           ; @020 0/2/3 @060 sOEP
+    EOR.W	D4,D2           ; @020 0/2/3 @060 pOEP
+    EOR.W	D5,D3           ; @020 0/2/3 @060 sOEP
+    EOR.W	D2,D4           ; @020 0/2/3 @060 pOEP
+    EOR.W	D3,D5           ; @020 0/2/3 @060 sOEP
+    ROL.L	D6,D4           ; @020 5/8/8 @060 pOEP
+    ROL.L	D6,D5           ; @020 5/8/8 @060 sOEP
+    MOVE.L	D4,D6           ; @020 0/2/3 @060 pOEP
+    MOVE.L	D5,D7           ; @020 0/2/3 @060 sOEP
+    LSR.L	#$02,D6         ; @020 1/4/4 @060 pOEP
+    LSR.L	#$02,D7         ; @020 1/4/4 @060 sOEP
+    EOR.L	D2,D6           ; @020 0/2/3 @060 pOEP
+    EOR.L	D3,D7           ; @020 0/2/3 @060 sOEP
+    AND.L	#$33333333,D6   ; @020 1/6/8 @060 pOEP
+    AND.L	#$33333333,D7   ; @020 1/6/8 @060 sOEP
+    EOR.L	D6,D2           ; @020 0/2/3 @060 pOEP
+    EOR.L	D7,D3           ; @020 0/2/3 @060 sOEP
+    LSL.L	#$02,D6         ; @020 1/4/4 @060 pOEP
+    LSL.L	#$02,D7         ; @020 1/4/4 @060 sOEP
+    EOR.L	D6,D4           ; @020 0/2/3 @060 pOEP
+    EOR.L	D7,D5           ; @020 0/2/3 @060 sOEP
+    MOVE.L	D2,D6           ; @020 0/2/3 @060 pOEP
+    MOVE.L	D3,D7           ; @020 0/2/3 @060 sOEP
+    LSR.L	#$08,D6         ; @020 1/4/4 @060 pOEP
+    LSR.L	#$08,D7         ; @020 1/4/4 @060 sOEP
+    EOR.L	D0,D6           ; @020 0/2/3 @060 pOEP
+    EOR.L	D1,D7           ; @020 0/2/3 @060 sOEP
+    AND.L	#$00ff00ff,D6   ; @020 1/6/8 @060 pOEP
+    AND.L	#$00ff00ff,D7   ; @020 1/6/8 @060 sOEP
+    EOR.L	D6,D0           ; @020 0/2/3 @060 pOEP
+    EOR.L	D7,D1           ; @020 0/2/3 @060 sOEP
+    LSL.L	#$08,D6         ; @020 1/4/4 @060 pOEP
+    LSL.L	#$08,D7         ; @020 1/4/4 @060 sOEP
+    EOR.L	D6,D2           ; @020 0/2/3 @060 pOEP
+    EOR.L	D7,D3           ; @020 0/2/3 @060 sOEP
+    MOVE.L	D1,D6           ; @020 0/2/3 @060 pOEP
+    MOVE.L	D3,D7           ; @020 0/2/3 @060 sOEP
+    LSR.L	#$04,D6         ; @020 1/4/4 @060 pOEP
+    LSR.L	#$04,D7         ; @020 1/4/4 @060 sOEP
+    EOR.L	D0,D6           ; @020 0/2/3 @060 pOEP
+    EOR.L	D2,D7           ; @020 0/2/3 @060 sOEP
+    AND.L	#$0f0f0f0f,D6   ; @020 1/6/8 @060 pOEP
+    AND.L	#$0f0f0f0f,D7   ; @020 1/6/8 @060 sOEP
+    EOR.L	D6,D0           ; @020 0/2/3 @060 pOEP
+    EOR.L	D7,D2           ; @020 0/2/3 @060 sOEP
+    LSL.L	#$04,D6         ; @020 1/4/4 @060 pOEP
+    LSL.L	#$04,D7         ; @020 1/4/4 @060 sOEP
+    EOR.L	D6,D1           ; @020 0/2/3 @060 pOEP
+    EOR.L	D7,D3           ; @020 0/2/3 @060 sOEP
+    MOVE.L	D2,D6           ; @020 0/2/3 @060 pOEP
+    MOVE.L	D3,D7           ; @020 0/2/3 @060 sOEP
+    LSR.L	#$01,D6         ; @020 1/4/4 @060 pOEP
+    LSR.L	#$01,D7         ; @020 1/4/4 @060 sOEP
+    EOR.L	D0,D6           ; @020 0/2/3 @060 pOEP
+    EOR.L	D1,D7           ; @020 0/2/3 @060 sOEP
+    AND.L	#$55555555,D6   ; @020 1/6/8 @060 pOEP
+    AND.L	#$55555555,D7   ; @020 1/6/8 @060 sOEP
+    EOR.L	D6,D0           ; @020 0/2/3 @060 pOEP
+    EOR.L	D7,D1           ; @020 0/2/3 @060 sOEP
+    LSL.L	#$01,D6         ; @020 1/4/4 @060 pOEP
+    LSL.L	#$01,D7         ; @020 1/4/4 @060 sOEP
+    EOR.L	D6,D2           ; @020 0/2/3 @060 pOEP
+    EOR.L	D7,D3           ; @020 0/2/3 @060 sOEP
+    MOVE.L	D2,$3e80(A1)    ; @020 3/5/7 @060 pOEP
+    MOVE.L	D3,$-3e80(A1)   ; @020 3/5/7 @060 pOEP
+    MOVE.L	D0,$5dc0(A1)    ; @020 3/5/7 @060 pOEP
+    MOVE.L	D1,$-1f40(A1)   ; @020 3/5/7 @060 pOEP
+    MOVE.L	A2,D2           ; @020 0/2/3 @060 sOEP
+    MOVE.L	A3,D3           ; @020 0/2/3 @060 pOEP
+    MOVE.L	D4,D6           ; @020 0/2/3 @060 sOEP
+    MOVE.L	D5,D7           ; @020 0/2/3 @060 pOEP
+    LSR.L	#$08,D6         ; @020 1/4/4 @060 sOEP
+    LSR.L	#$08,D7         ; @020 1/4/4 @060 pOEP
+    EOR.L	D2,D6           ; @020 0/2/3 @060 sOEP
+    EOR.L	D3,D7           ; @020 0/2/3 @060 pOEP
+    AND.L	#$00ff00ff,D6   ; @020 1/6/8 @060 sOEP
+    AND.L	#$00ff00ff,D7   ; @020 1/6/8 @060 pOEP
+    EOR.L	D6,D2           ; @020 0/2/3 @060 sOEP
+    EOR.L	D7,D3           ; @020 0/2/3 @060 pOEP
+    LSL.L	#$08,D6         ; @020 1/4/4 @060 sOEP
+    LSL.L	#$08,D7         ; @020 1/4/4 @060 pOEP
+    EOR.L	D6,D4           ; @020 0/2/3 @060 sOEP
+    EOR.L	D7,D5           ; @020 0/2/3 @060 pOEP
+    MOVE.L	D3,D6           ; @020 0/2/3 @060 sOEP
+    MOVE.L	D5,D7           ; @020 0/2/3 @060 pOEP
+    LSR.L	#$04,D6         ; @020 1/4/4 @060 sOEP
+    LSR.L	#$04,D7         ; @020 1/4/4 @060 pOEP
+    EOR.L	D2,D6           ; @020 0/2/3 @060 sOEP
+    EOR.L	D4,D7           ; @020 0/2/3 @060 pOEP
+    AND.L	#$0f0f0f0f,D6   ; @020 1/6/8 @060 sOEP
+    AND.L	#$0f0f0f0f,D7   ; @020 1/6/8 @060 pOEP
+    EOR.L	D6,D2           ; @020 0/2/3 @060 sOEP
+    EOR.L	D7,D4           ; @020 0/2/3 @060 pOEP
+    LSL.L	#$04,D6         ; @020 1/4/4 @060 sOEP
+    LSL.L	#$04,D7         ; @020 1/4/4 @060 pOEP
+    EOR.L	D6,D3           ; @020 0/2/3 @060 sOEP
+    EOR.L	D7,D5           ; @020 0/2/3 @060 pOEP
+    MOVE.L	D4,D6           ; @020 0/2/3 @060 sOEP
+    MOVE.L	D5,D7           ; @020 0/2/3 @060 pOEP
+    LSR.L	#$01,D6         ; @020 1/4/4 @060 sOEP
+    LSR.L	#$01,D7         ; @020 1/4/4 @060 pOEP
+    EOR.L	D2,D6           ; @020 0/2/3 @060 sOEP
+    EOR.L	D3,D7           ; @020 0/2/3 @060 pOEP
+    AND.L	#$55555555,D6   ; @020 1/6/8 @060 sOEP
+    AND.L	#$55555555,D7   ; @020 1/6/8 @060 pOEP
+    EOR.L	D6,D2           ; @020 0/2/3 @060 sOEP
+    EOR.L	D7,D3           ; @020 0/2/3 @060 pOEP
+    LSL.L	#$01,D6         ; @020 1/4/4 @060 sOEP
+    LSL.L	#$01,D7         ; @020 1/4/4 @060 pOEP
+    EOR.L	D6,D4           ; @020 0/2/3 @060 sOEP
+    EOR.L	D7,D5           ; @020 0/2/3 @060 pOEP
+    MOVE.L	D2,$1f40(A1)    ; @020 3/5/7 @060 sOEP
+    MOVE.L	D3,$-5dc0(A1)   ; @020 3/5/7 @060 pOEP
+    MOVE.L	D5,$-7d00(A1)   ; @020 3/5/7 @060 pOEP
+    MOVE.L	D4,(A1)         ; @020 3/4/5 @060 pOEP
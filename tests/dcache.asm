@@ -0,0 +1,10 @@
+; Reads and (write-allocated) stores stream through buffers, so every 4th
+; iteration misses in the data cache twice. The value a1 points to stays in
+; the cache after the first access.
+; @060.loop 3 @060.dcache 12.98
+.loop:
+        add.l   (a0)+,d2        ; @020 4/6/7 @060 pOEP
+        subq.l  #1,d0           ; @060 sOEP
+        move.l  d2,(a2)+        ; @020 4/4/5 @060 pOEP
+        add.l   (a1),d3         ; @020 3/6/7 @060 pOEP
+        bne.b   .loop
@@ -1,6 +1,7 @@
+; @020.loop 6/18/25 @060.loop 2
 .loop:
-        move.l  (a0),a1
-        moveq   #0,d1
-        moveq   #0,d2
-        subq.w  #1,d0
-        bne.b   .loop
+        move.l  (a0),a1         ; @020 3/6/7 @060 pOEP
+        moveq   #0,d1           ; @020 0/2/3 @060 sOEP
+        moveq   #0,d2           ; @020 0/2/3 @060 pOEP
+        subq.w  #1,d0           ; @020 0/2/3 @060 sOEP
+        bne.b   .loop           ; @020 3/6/9 @060 -
@@ -1,11 +1,12 @@
-				move.w	d5,d3
-				lsr.w	#8,d3
-				move.b	d3,d6
-				move.w	d0,d3
-				move.b	(a0,d6.w*4),d3
-				add.w	d1,d0
-				add.l	d2,d5
-				and.l	d4,d5
-				move.l	d5,d6
-				swap	d6
-				move.b	(a1,d3.w),(a3)+
+; @020.loop 13/41/53 @060.loop 12
+				move.w	d5,d3 ; @020 0/2/3 @060 pOEP
+				lsr.w	#8,d3 ; @020 1/4/4 @060 pOEP
+				move.b	d3,d6 ; @020 0/2/3 @060 pOEP
+				move.w	d0,d3 ; @020 0/2/3 @060 sOEP
+				move.b	(a0,d6.w*4),d3 ; @020 4/9/11 @060 pOEP
+				add.w	d1,d0 ; @020 0/2/3 @060 sOEP
+				add.l	d2,d5 ; @020 0/2/3 @060 pOEP
+				and.l	d4,d5 ; @020 0/2/3 @060 pOEP
+				move.l	d5,d6 ; @020 0/2/3 @060 pOEP
+				swap	d6 ; @020 1/4/4 @060 pOEP
+				move.b	(a1,d3.w),(a3)+ ; @020 7/10/13 @060 pOEP
@@ -1,12 +1,13 @@
-        move.l  d0,d3           ; d3=00Cc
-        add.l   a2,d5           ; uv += duvdx
-        add.w   d4,d0           ; c += dcdx
-        move.b  (a0,d6.l*4),d3  ; d3=00CT
-        and.l   d1,d5           ; uv &= uvmask
-        move.l  d5,d6           ; d6=VvUu
-        lsr.l   #8,d6           ; d6=0VvU
-        move.l  d6,d2           ; d2=0VvU
-        lsr.l   #8,d6           ; d6=00Vv
-        move.b  d2,d6           ; d6=00VU
-        move.b  (a1,d3.l),(a3)+
-        dbf     d7,.loop
+; @020.loop 16/47/62 @060.loop 9
+        move.l  d0,d3           ; d3=00Cc @020 0/2/3 @060 pOEP
+        add.l   a2,d5           ; uv += duvdx @020 0/2/3 @060 sOEP
+        add.w   d4,d0           ; c += dcdx @020 0/2/3 @060 pOEP
+        move.b  (a0,d6.l*4),d3  ; d3=00CT @020 4/9/11 @060 sOEP
+        and.l   d1,d5           ; uv &= uvmask @020 0/2/3 @060 pOEP
+        move.l  d5,d6           ; d6=VvUu @020 0/2/3 @060 pOEP
+        lsr.l   #8,d6           ; d6=0VvU @020 1/4/4 @060 sOEP
+        move.l  d6,d2           ; d2=0VvU @020 0/2/3 @060 pOEP
+        lsr.l   #8,d6           ; d6=00Vv @020 1/4/4 @060 sOEP
+        move.b  d2,d6           ; d6=00VU @020 0/2/3 @060 pOEP
+        move.b  (a1,d3.l),(a3)+ ; @020 7/10/13 @060 pOEP
+        dbf     d7,.loop        ; @020 3/6/9 @060 pOEP
@@ -1,13 +1,14 @@
-   add.l   a2,d5           ;pOEP
-   move.l  d0,d3           ;sOEP
-   and.l   d1,d5           ;pOEP
-   move.b  (a0,d6.l*4),d3  ;sOEP
-   move.l  d5,d6           ;pOEP
-   lsr.l   #8,d6           ;sOEP
-   add.w   d4,d0           ;pOEP
-   lsl.w   #8,d6           ;sOEP
-   move.b  (a1,d3.l),d3    ;pOEP
-   lsr.l   #8,d6           ;sOEP
-   move.b  d3,(a3)+        ;pOEP
-   subq.w  #1,d7           ;sOEP
-   bne.b   .loop           ;free
+; @020.loop 18/52/66 @060.loop 7
+   add.l   a2,d5           ;pOEP @020 0/2/3 @060 pOEP
+   move.l  d0,d3           ;sOEP @020 0/2/3 @060 sOEP
+   and.l   d1,d5           ;pOEP @020 0/2/3 @060 pOEP
+   move.b  (a0,d6.l*4),d3  ;sOEP @020 4/9/11 @060 sOEP
+   move.l  d5,d6           ;pOEP @020 0/2/3 @060 pOEP
+   lsr.l   #8,d6           ;sOEP @020 1/4/4 @060 sOEP
+   add.w   d4,d0           ;pOEP @020 0/2/3 @060 pOEP
+   lsl.w   #8,d6           ;sOEP @020 1/4/4 @060 sOEP
+   move.b  (a1,d3.l),d3    ;pOEP @020 4/9/11 @060 pOEP
+   lsr.l   #8,d6           ;sOEP @020 1/4/4 @060 sOEP
+   move.b  d3,(a3)+        ;pOEP @020 4/4/5 @060 pOEP
+   subq.w  #1,d7           ;sOEP @020 0/2/3 @060 sOEP
+   bne.b   .loop           ;free @020 3/6/9 @060 -
@@ -0,0 +1,15 @@
+; Memory to memory moves are pOEP-until-last: They take two cycles in the pOEP
+; and the sOEP instruction executes in the last one. Two reads plus a write
+; can only be issued to the pOEP on its own. The AGU updates (An)+ in the first
+; cycle, so a0 can be used right away.
+; @020.loop 33/52/70 @060.loop 10
+.loop:
+        move.l  (a0),(a1)       ; @060 pOEP
+        addq.l  #4,a0           ; @060 sOEP
+        move.l  4(a2),8(a3)     ; @060 pOEP
+        addq.l  #4,a1           ; @060 sOEP
+        add.l   (a4),(a5)       ; @060 pOEP
+        move.l  (a0)+,(a1)+     ; @060 pOEP
+        add.l   (a0),d1         ; @060 pOEP
+        subq.l  #1,d0           ; @060 sOEP
+        bne.b   .loop
@@ -1,8 +1,9 @@
-        mulu.w  d0,d1
-        muls.w  d0,d1
-        mulu.l  d0,d1
-        muls.l  d0,d1
-        divu.w  d0,d1
-        divs.w  d0,d1
-        divu.l  d0,d1
-        divs.l  d0,d1
+; @020.loop 392/416/427 @060.loop 128
+        mulu.w  d0,d1           ; @020 25/27/28 @060 pOEP
+        muls.w  d0,d1           ; @020 25/27/28 @060 pOEP
+        mulu.l  d0,d1           ; @020 41/45/47 @060 pOEP
+        muls.l  d0,d1           ; @020 41/45/47 @060 pOEP
+        divu.w  d0,d1           ; @020 42/44/44 @060 pOEP
+        divs.w  d0,d1           ; @020 54/56/57 @060 pOEP
+        divu.l  d0,d1           ; @020 76/80/82 @060 pOEP
+        divs.l  d0,d1           ; @020 88/92/94 @060 pOEP
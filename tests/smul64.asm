@@ -1,28 +1,29 @@
-        move.l  #$ffff,d7
-        moveq   #16,d6
-        move.l  d0,d2
-        asr.l   d6,d2
-        and.l   d7,d0
-        move.l  d1,d4
-        asr.l   d6,d4
-        and.l   d7,d1
-        move.l  d0,d3
-        mulu.w  d1,d3
-        move.l  d3,d5
-        lsr.l   d6,d5
-        muls.l  d2,d1
-        add.l   d5,d1
-        move.l  d1,d5
-        and.l   d7,d5
-        muls.l  d4,d0
-        add.l   d5,d0
-        muls.l  d4,d2
-        asr.l   d6,d1
-        add.l   d1,d2
-        move.l  d0,d1
-        asr.l   d6,d1
-        add.l   d1,d2
-        lsl.l   d6,d0
-        and.l   d7,d3
-        add.l   d3,d0
+; @020.loop 166/236/258 @060.loop 22
+        move.l  #$ffff,d7       ; @020 0/6/5 @060 pOEP
+        moveq   #16,d6          ; @020 0/2/3 @060 sOEP
+        move.l  d0,d2           ; @020 0/2/3 @060 pOEP
+        asr.l   d6,d2           ; @020 3/6/6 @060 sOEP
+        and.l   d7,d0           ; @020 0/2/3 @060 pOEP
+        move.l  d1,d4           ; @020 0/2/3 @060 sOEP
+        asr.l   d6,d4           ; @020 3/6/6 @060 pOEP
+        and.l   d7,d1           ; @020 0/2/3 @060 sOEP
+        move.l  d0,d3           ; @020 0/2/3 @060 pOEP
+        mulu.w  d1,d3           ; @020 25/27/28 @060 pOEP
+        move.l  d3,d5           ; @020 0/2/3 @060 pOEP
+        lsr.l   d6,d5           ; @020 3/6/6 @060 sOEP
+        muls.l  d2,d1           ; @020 41/45/47 @060 pOEP
+        add.l   d5,d1           ; @020 0/2/3 @060 pOEP
+        move.l  d1,d5           ; @020 0/2/3 @060 pOEP
+        and.l   d7,d5           ; @020 0/2/3 @060 sOEP
+        muls.l  d4,d0           ; @020 41/45/47 @060 pOEP
+        add.l   d5,d0           ; @020 0/2/3 @060 pOEP
+        muls.l  d4,d2           ; @020 41/45/47 @060 pOEP
+        asr.l   d6,d1           ; @020 3/6/6 @060 pOEP
+        add.l   d1,d2           ; @020 0/2/3 @060 pOEP
+        move.l  d0,d1           ; @020 0/2/3 @060 sOEP
+        asr.l   d6,d1           ; @020 3/6/6 @060 pOEP
+        add.l   d1,d2           ; @020 0/2/3 @060 pOEP
+        lsl.l   d6,d0           ; @020 3/6/6 @060 sOEP
+        and.l   d7,d3           ; @020 0/2/3 @060 pOEP
+        add.l   d3,d0           ; @020 0/2/3 @060 pOEP
 
@@ -0,0 +1,120 @@
+#include "timeline.h"
+#include "cpu_model_020.h"
+#include "cpu_model_060.h"
+
+void timeline_sink_060::on(const dispatch_event& e)
+{
+    auto& s = stall_[static_cast<int>(e.pipe)];
+    auto& r = res_.instructions[e.pos];
+    r = {};
+    r.cycle = e.cycle + e.stall;
+    r.cycles = e.cycles - e.stall;
+    r.pipe = e.pipe;
+    r.stall = s.cycles;
+    r.stall_reg = s.reg;
+    s = {};
+    r.data_cache_stall = data_cache_stall_[static_cast<int>(e.pipe)];
+    data_cache_stall_[static_cast<int>(e.pipe)] = 0;
+    if (e.pipe == oep::poep) {
+        r.fetch_stall = fetch_stall_;
+        fetch_stall_ = 0;
+    }
+}
+
+void timeline_sink_060::on(const stall_event& e)
+{
+    stall_[static_cast<int>(e.pipe)] = e;
+}
+
+void timeline_sink_060::on(const fetch_stall_event& e)
+{
+    fetch_stall_ = e.cycles;
+}
+
+void timeline_sink_060::on(const data_cache_miss_event& e)
+{
+    data_cache_stall_[static_cast<int>(e.pipe)] = e.cycles;
+}
+
+void timeline_sink_060::on(const soep_idle_event& e)
+{
+    res_.instructions[e.pos].soep_idle = e.check;
+}
+
+void timeline_sink_060::on(const branch_event& e)
+{
+    auto& s = stall_[static_cast<int>(oep::poep)];
+    auto& r = res_.instructions[e.pos];
+    r = {};
+    r.cycle = e.cycle;
+    r.cycles = e.cycles;
+    r.branch = true;
+    r.taken = e.taken;
+    r.mispredicted = e.taken != e.predicted_taken;
+    r.stall = s.cycles;
+    r.stall_reg = s.reg;
+    s = {};
+    r.fetch_stall = fetch_stall_;
+    fetch_stall_ = 0;
+}
+
+void timeline_sink_060::on(const end_event& e)
+{
+    res_.unroll = e.unroll;
+    res_.cycles = e.cycles;
+}
+
+namespace {
+
+class timeline_sink_020 : public event_sink {
+public:
+    explicit timeline_sink_020(timeline_020& res)
+        : res_ { res }
+    {
+    }
+
+    void on(const cost_event& e) override
+    {
+        res_.instructions[e.pos] = { e.cost, e.assumed_taken };
+    }
+
+    void on(const end_event& e) override
+    {
+        res_.total = e.total;
+    }
+
+private:
+    timeline_020& res_;
+};
+
+} // unnamed namespace
+
+timeline_builder::timeline_builder(const options_060& opts_060)
+    : cpu_060_ { make_cpu_model_060(null_os_, insts_, opts_060) }
+    , cpu_020_ { make_cpu_model_020(null_os_, insts_) }
+{
+}
+
+void timeline_builder::load(instruction_view insts, cpu_model& cpu)
+{
+    insts_.clear();
+    for (size_t i = 0; i < insts.size(); ++i)
+        insts_.push_back(insts[i]);
+    cpu.instructions_changed();
+}
+
+void timeline_builder::simulate_060(instruction_view insts, int unroll, timeline_060& res)
+{
+    load(insts, *cpu_060_);
+    res.instructions.resize(insts.size() * (unroll + 1));
+    timeline_sink_060 sink { res };
+    cpu_060_->simulate(unroll, sink);
+}
+
+void timeline_builder::simulate_020(instruction_view insts, timeline_020& res)
+{
+    load(insts, *cpu_020_);
+    res.instructions.resize(insts.size());
+    timeline_sink_020 sink { res };
+    cpu_020_->simulate(0, sink);
+}
@@ -0,0 +1,93 @@
+#ifndef TIMELINE_H_INCLUDED
+#define TIMELINE_H_INCLUDED
+
+#include <vector>
+#include <memory>
+#include <ostream>
+#include "cpu_model_060.h"
+#include "packed_instruction.h"
+
+// Structured simulation results for embedding the models.
+//
+// The results are plain vectors owned by the caller. Reusing the same result
+// objects (and timeline_builder) for many loops doesn't allocate once the
+// buffers have grown large enough.
+
+// 68060: One instruction of the (unrolled) instruction stream
+struct issue_060 {
+    int cycle; // Issue cycle (after any stall)
+    int cycles; // Execution cycles, 0 for folded branches (correctly predicted taken)
+    oep pipe;
+    bool branch;
+    bool taken; // Branches only
+    bool mispredicted; // Branches only
+    int stall; // Change/use stall cycles before issue
+    eareg stall_reg; // Register the stall waited for
+    int fetch_stall; // Further cycles waiting for the instruction to be fetched
+    int data_cache_stall; // Further cycles waiting for line fills (of this instruction's operands)
+    soep_check soep_idle; // pOEP: why the next instruction wasn't issued to the sOEP (reason none if it was)
+};
+
+struct timeline_060 {
+    std::vector<issue_060> instructions; // Indexed by position in the stream, (unroll+1) * loop size
+    int unroll;
+    int cycles; // Total for all iterations
+
+    double cycles_per_iteration() const
+    {
+        return static_cast<double>(cycles) / (unroll + 1);
+    }
+};
+
+// 68020: Cost of one instruction of the loop
+struct instruction_cost_020 {
+    cycle_counts cost;
+    bool assumed_taken; // Branch (or dbra) cost assumes it's taken
+};
+
+struct timeline_020 {
+    std::vector<instruction_cost_020> instructions; // One iteration
+    cycle_counts total; // Per iteration
+};
+
+// Fills a timeline_060 from the events of the 68060 model. Writes the entries
+// for the positions it sees, so the caller sizes the vector.
+class timeline_sink_060 : public event_sink {
+public:
+    explicit timeline_sink_060(timeline_060& res)
+        : res_ { res }
+    {
+    }
+
+    void on(const dispatch_event& e) override;
+    void on(const stall_event& e) override;
+    void on(const fetch_stall_event& e) override;
+    void on(const data_cache_miss_event& e) override;
+    void on(const soep_idle_event& e) override;
+    void on(const branch_event& e) override;
+    void on(const end_event& e) override;
+
+private:
+    timeline_060& res_;
+    stall_event stall_[2] {}; // Pending stall of each OEP
+    int fetch_stall_ = 0; // Pending fetch stall (pOEP)
+    int data_cache_stall_[2] {}; // Pending line fill stall of each OEP
+};
+
+class timeline_builder {
+public:
+    explicit timeline_builder(const options_060& opts_060 = {});
+
+    void simulate_060(instruction_view insts, int unroll, timeline_060& res);
+    void simulate_020(instruction_view insts, timeline_020& res);
+
+private:
+    std::ostream null_os_ { nullptr };
+    std::vector<instruction> insts_; // Copy of the loop being simulated, the models refer to it
+    std::unique_ptr<cpu_model> cpu_060_;
+    std::unique_ptr<cpu_model> cpu_020_;
+
+    void load(instruction_view insts, cpu_model& cpu);
+};
+
+#endif
@@ -0,0 +1,131 @@
+#include "trace.h"
+#include "timeline.h"
+#include "json.h"
+#include <ostream>
+#include <sstream>
+
+namespace {
+
+enum track {
+    track_poep = 1,
+    track_soep,
+    track_memory,
+};
+
+template<typename T>
+std::string to_string(const T& t)
+{
+    std::ostringstream oss;
+    oss << t;
+    return oss.str();
+}
+
+json metadata(const char* what, int tid, const std::string& name)
+{
+    json e;
+    e["name"] = what;
+    e["ph"] = "M";
+    e["pid"] = 1;
+    e["tid"] = tid;
+    e["args"]["name"] = name;
+    return e;
+}
+
+json slice(const std::string& name, const char* category, track tid, int start_cycle, int cycles)
+{
+    json e;
+    e["name"] = name;
+    e["cat"] = category;
+    e["ph"] = "X";
+    e["pid"] = 1;
+    e["tid"] = static_cast<int>(tid);
+    e["ts"] = start_cycle - 1;
+    e["dur"] = cycles;
+    return e;
+}
+
+} // unnamed namespace
+
+void write_chrome_trace(instruction_view insts, int unroll, const std::string& name, std::ostream& os, const options_060& opts)
+{
+    timeline_060 t {};
+    timeline_builder { opts }.simulate_060(insts, unroll, t);
+
+    auto events = json::array();
+    events.push_back(metadata("process_name", 0, "68060 " + name));
+    events.push_back(metadata("thread_name", track_poep, "pOEP"));
+    events.push_back(metadata("thread_name", track_soep, "sOEP"));
+    events.push_back(metadata("thread_name", track_memory, "Memory"));
+
+    for (size_t pos = 0; pos < t.instructions.size(); ++pos) {
+        const auto& r = t.instructions[pos];
+        const auto inst = insts[pos % insts.size()];
+        auto text = to_string(inst);
+        for (auto& ch : text) {
+            if (ch == '\t')
+                ch = ' ';
+        }
+        const auto tid = r.pipe == oep::soep ? track_soep : track_poep;
+
+        if (r.stall) {
+            auto e = slice("stall " + to_string(r.stall_reg), "stall", tid, r.cycle - r.data_cache_stall - r.fetch_stall - r.stall, r.stall);
+            e["args"]["reason"] = "Change/use stall waiting for " + to_string(r.stall_reg);
+            events.push_back(std::move(e));
+        }
+        if (r.fetch_stall) {
+            auto e = slice("fetch", "stall", tid, r.cycle - r.data_cache_stall - r.fetch_stall, r.fetch_stall);
+            e["args"]["reason"] = "Waiting for the instruction to be fetched";
+            events.push_back(std::move(e));
+        }
+        if (r.data_cache_stall) {
+            auto e = slice("line fill", "stall", track_memory, r.cycle - r.data_cache_stall, r.data_cache_stall);
+            e["args"]["reason"] = "Data cache miss in " + text;
+            events.push_back(std::move(e));
+        }
+
+        if (r.branch) {
+            const char* note = r.mispredicted ? "Mispredicted" : r.taken ? "Folded (correctly predicted taken)" : "Correctly predicted not taken";
+            if (r.cycles) {
+                auto e = slice(text, "branch", track_poep, r.cycle, r.cycles);
+                e["args"]["note"] = note;
+                events.push_back(std::move(e));
+                continue;
+            }
+            json e;
+            e["name"] = text;
+            e["cat"] = "branch";
+            e["ph"] = "i";
+            e["s"] = "t";
+            e["pid"] = 1;
+            e["tid"] = static_cast<int>(track_poep);
+            e["ts"] = r.cycle - 1;
+            e["args"]["note"] = note;
+            events.push_back(std::move(e));
+            continue;
+        }
+
+        auto e = slice(text, "instruction", tid, r.cycle, r.cycles);
+        e["args"]["position"] = pos;
+        e["args"]["iteration"] = pos / insts.size();
+        e["args"]["index"] = pos % insts.size();
+        events.push_back(std::move(e));
+
+        if (const int mem_cycles = inst.mem_cycles())
+            events.push_back(slice(text, "memory", track_memory, r.cycle, mem_cycles));
+
+        if (r.soep_idle.reason != soep_reason::none) {
+            std::ostringstream reason;
+            print_reason(reason, r.soep_idle, inst, insts[(pos + 1) % insts.size()]);
+            auto idle = slice("idle", "idle", track_soep, r.cycle, r.cycles);
+            idle["args"]["reason"] = reason.str();
+            events.push_back(std::move(idle));
+        }
+    }
+
+    json trace;
+    trace["traceEvents"] = std::move(events);
+    trace["displayTimeUnit"] = "ns";
+    trace["otherData"]["cycles"] = t.cycles;
+    trace["otherData"]["iterations"] = unroll + 1;
+    os << trace << "\n";
+}
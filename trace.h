@@ -0,0 +1,17 @@
+#ifndef TRACE_H_INCLUDED
+#define TRACE_H_INCLUDED
+
+#include <vector>
+#include <string>
+#include <iosfwd>
+#include "packed_instruction.h"
+#include "cpu_model_060.h"
+
+// Writes the 68060 simulation of unroll+1 iterations as Chrome trace event json
+// (chrome://tracing, Perfetto). One cycle is shown as one microsecond.
+//
+// Tracks: pOEP and sOEP with a slice per instruction, change/use and fetch stalls and idle
+// sOEP slots as separately named slices, and the memory port (operand accesses).
+void write_chrome_trace(instruction_view insts, int unroll, const std::string& name, std::ostream& os, const options_060& opts = {});
+
+#endif